@@ -1,17 +0,0 @@
-#for f in inputs/ssa*
-#for f in inputs/aim*-200*
-#for f in inputs/aim*-50*
-#for f in inputs/aim*no*
-#for f in inputs/aim*yes*
-#for f in inputs/aim*-100*
-#for f in inputs/aim*
-#for f in inputs/uf125-*
-#for f in inputs/fla*35*
-echo "uf75"
-time ./R.sh uf75
-echo "uuf75"
-time ./R.sh uuf75
-echo "uf100"
-time ./R.sh uf100-02
-echo "uuf100"
-time ./R.sh uuf100-02
@@ -3,6 +3,7 @@
 
 #include "cnf.h"
 #include "literal_map.h"
+#include "clause_scan.h"
 #include "small_set.h"
 #include "debug.h"
 
@@ -39,9 +40,7 @@ class assignment {
         // Note: sometimes we'll have implied literals
         // that are at level -1. So we'll still have some
         // literals implied, that's fine.
-        while (level > 0) {
-            pop_level();
-        }
+        backtrack_to(-1);
     }
 
     bool is_true(literal l) const;
@@ -50,17 +49,22 @@ class assignment {
 
     void push_decision(literal l);
     void push_implicant(literal l, cnf::clause_iterator c);
+    // For chronological backtracking: l goes on the end of the trail, but
+    // at the level its reason says, which may be below the current one.
+    void push_implicant(literal l, cnf::clause_iterator c, int at_level);
 
     const int literal_count;
 
 
     assignment(int literal_count):
         literal_count(literal_count),
-        is_assigned_true(literal_count),
+        values(literal_count),
         lit_dec_level(literal_count),
+        trail_index(literal_count),
         decision_sequence(std::make_unique<literal[]>(literal_count)),
         Parent(std::make_unique<cnf::clause_iterator[]>(literal_count)),
-        left_right(std::make_unique<int[]>(literal_count))
+        left_right(std::make_unique<int[]>(literal_count)),
+        level_start(std::make_unique<int[]>(literal_count + 1))
     {}
 
     assignment(cnf& c): assignment(c.max_literal_count) {
@@ -74,17 +78,20 @@ class assignment {
 
     int level = 0;
     int assigned_count = 0;
+    // Set once anything's been implied below the current level; the trail
+    // is then no longer sorted by level.
+    bool out_of_order = false;
 
     public:
     int decision_level() { return level; }
-    int* first_lit_latest_level() {
+    literal* first_lit_latest_level() {
         int i = 0;
         while (lit_dec_level[decision_sequence[i]] != level-1) {
             i++;
         }
         return decision_sequence.get() + i;
     }
-    int* last_lit_latest_level() {
+    literal* last_lit_latest_level() {
         return decision_sequence.get() + assigned_count;
     }
 
@@ -93,13 +100,14 @@ class assignment {
         ASSERT(level > 0);
         ASSERT(assigned_count > 0);
         level--;
-        literal lit_actual = 0;
+        literal lit_actual;
         while (assigned_count > 0 &&
                lit_dec_level[decision_sequence[assigned_count-1]] == level) {
             lit_actual = decision_sequence[assigned_count-1];
             assigned_count--;
             Parent[assigned_count] = nullptr;
-            is_assigned_true[lit_actual] = false;
+            values[lit_actual] = 0;
+            values[-lit_actual] = 0;
         }
         //return lit_actual;
     }
@@ -108,13 +116,53 @@ class assignment {
         ASSERT(level > 0);
         ASSERT(assigned_count > 0);
         literal lit_actual = decision_sequence[assigned_count-1];
-        is_assigned_true[lit_actual] = false;
+        values[lit_actual] = 0;
+        values[-lit_actual] = 0;
 
         assigned_count--;
         Parent[assigned_count] = nullptr;
         level = lit_dec_level[decision_sequence[assigned_count-1]]+1;
     }
 
+    // Unassign every literal above level target, keeping the rest in trail
+    // order. With an ordered trail that's just popping levels; otherwise
+    // lower-level literals past target's decisions get slid down. Returns
+    // the first trail position that changed: the literals from there on
+    // were assigned in a different context, so their watches need
+    // looking at again.
+    //
+    // Like the pops, this leaves the literals it unassigned just past
+    // end() (in trail order) until the next push, for anyone who wants to
+    // know what came off.
+    int backtrack_to(int target) {
+        TRACE("A: backtrack_to ", target, "\n");
+        ASSERT(target >= -1);
+        if (target >= curr_level()) { return assigned_count; }
+        const int from = level_start[target + 1];
+        int kept = from;
+        unassigned.clear();
+        for (int i = from; i < assigned_count; ++i) {
+            literal l = decision_sequence[i];
+            if (lit_dec_level[l] <= target) {
+                decision_sequence[kept] = l;
+                trail_index[l] = kept;
+                Parent[kept] = Parent[i];
+                left_right[kept] = left_right[i];
+                kept++;
+            }
+            else {
+                values[l] = 0;
+                values[-l] = 0;
+                unassigned.push_back(l);
+            }
+        }
+        std::copy(unassigned.begin(), unassigned.end(), decision_sequence.get() + kept);
+        for (int i = kept; i < assigned_count; ++i) { Parent[i] = nullptr; }
+        assigned_count = kept;
+        level = target + 1;
+        return from;
+    }
+
     bool curr_lit_is_implied() {
         return Parent[assigned_count-1] != nullptr;
     }
@@ -127,7 +175,19 @@ class assignment {
     template<typename C>
     int max_literal_level(const C& c) {
         int m = -1;
-        for (int x : c) {
+        for (literal x : c) {
+            ASSERT(is_false(x));
+            m = std::max(m, lit_dec_level[-x]);
+        }
+        return m;
+    }
+
+    // The level at which clause c implies l: that of its latest other
+    // literal (-1 if there's none).
+    int implication_level(cnf::clause_iterator c, literal l) const {
+        int m = -1;
+        for (literal x : c) {
+            if (x == l) { continue; }
             ASSERT(is_false(x));
             m = std::max(m, lit_dec_level[-x]);
         }
@@ -141,7 +201,7 @@ class assignment {
         ASSERT(level >= 0);
         ASSERT(assigned_count >= level);
         if (assigned_count == 0) { return true; }
-        for (int i = 1; i < assigned_count; ++i) {
+        for (int i = 1; i < assigned_count && !out_of_order; ++i) {
             DBGSTMT(literal curr = decision_sequence[i]);
             DBGSTMT(literal prev = decision_sequence[i-1]);
             ASSERT(lit_dec_level[curr] == lit_dec_level[prev] ||
@@ -151,7 +211,18 @@ class assignment {
         //          << decision_sequence[assigned_count-1] << " "
         //          << lit_dec_level[decision_sequence[assigned_count-1]] << " "
         //          << (level-1) << std::endl;
-        ASSERT(lit_dec_level[decision_sequence[assigned_count-1]] == level-1);
+        ASSERT(out_of_order || lit_dec_level[decision_sequence[assigned_count-1]] == level-1);
+        // Out of order or not, the decisions are, and nothing's above the
+        // decision it follows.
+        for (int i = 0, decisions = 0; i < assigned_count; ++i) {
+            DBGSTMT(literal curr = decision_sequence[i]);
+            if (left_right[i] == L) {
+                ASSERT(lit_dec_level[curr] == decisions);
+                ASSERT(level_start[decisions] == i);
+                decisions++;
+            }
+            ASSERT(lit_dec_level[curr] < decisions);
+        }
 
         // the levels are monotically increasing.
         //int level_tracer = 0;
@@ -166,7 +237,7 @@ class assignment {
 
         // make sure the assigned_true is consistent with our decision_sequnece
         for (int i = 0; i < assigned_count; ++i) {
-            ASSERT(is_assigned_true[decision_sequence[i]]);
+            ASSERT(is_true(decision_sequence[i]));
 
             // Exactly every R better have a parent clause.
             if (left_right[i] == R) { ASSERT(Parent[i]); }
@@ -174,30 +245,23 @@ class assignment {
         }
 
         // everything assigned true should be in the decision sequence.
-        for (int i = is_assigned_true.first_index();
-             i != is_assigned_true.end_index();
-             ++i) {
-            if (i == 0) { continue; }
-            if (is_assigned_true[i]) {
+        for (unsigned i = values.first_index(); i != values.end_index(); ++i) {
+            literal l(i);
+            if (is_true(l)) {
                 ASSERT(std::find(decision_sequence.get(),
                                  decision_sequence.get()+assigned_count,
-                                 i) != decision_sequence.get()+assigned_count);
-            }
-        }
-        // no two equiv. literals are assigned simultaneously.
-        for (int i = is_assigned_true.first_index();
-             i != is_assigned_true.end_index();
-             ++i) {
-            if (i == 0) { continue; }
-            if (is_assigned_true[i]) {
-                ASSERT(!is_assigned_true[-i]);
+                                 l) != decision_sequence.get()+assigned_count);
             }
+            // no two equiv. literals are assigned simultaneously.
+            ASSERT(values[l] == -values[-l]);
         }
 
         return true;
     };
 
-    literal_map<bool> is_assigned_true;
+    // 1 if the literal is true, -1 if it's false, 0 if unassigned: both
+    // polarities are written on assignment so each query is one load.
+    literal_map<signed char> values;
 
     literal* begin() const {
         return decision_sequence.get();
@@ -212,18 +276,22 @@ class assignment {
     literal* rend() const {
         return decision_sequence.get() - 1;
     }
+    // Where l is on the trail (l must be true).
     int decision_number(literal l) const {
-        auto it = std::find(decision_sequence.get(),
-                            decision_sequence.get() + assigned_count,
-                            l);
-        ASSERT(it != decision_sequence.get() + assigned_count);
-        return it - decision_sequence.get();
+        ASSERT(is_true(l));
+        ASSERT(decision_sequence[trail_index[l]] == l);
+        return trail_index[l];
     }
     int decision_level(literal l) const {
         ASSERT(!is_unassigned(l));
-        return lit_dec_level.get_copy(l);
+        return lit_dec_level[l];
     }
 
+    // The clause that implied the i-th literal of the trail (nullptr for decisions).
+    cnf::clause_iterator reason_at(int i) const { return Parent[i]; }
+    // The clause that implied l (nullptr for decisions); l must be true.
+    cnf::clause_iterator reason_of(literal l) const { return Parent[decision_number(l)]; }
+
     bool is_reason_clause(const cnf::clause_iterator cit) const {
         for (int i = 0; i < assigned_count; ++i) {
             if (Parent[i] == cit) { return true; }
@@ -231,27 +299,44 @@ class assignment {
         return false;
     }
     private:
-    literal_map<int> lit_dec_level;
+    variable_map<int> lit_dec_level;
+    variable_map<int> trail_index;
     std::unique_ptr<literal[]> decision_sequence;
     std::unique_ptr<cnf::clause_iterator[]> Parent;
     std::unique_ptr<int[]> left_right;
+    // The trail position of each level's decision.
+    std::unique_ptr<int[]> level_start;
+    std::vector<literal> unassigned; // scratch for backtrack_to
 };
 
 literal* begin(const assignment& a) { return a.begin(); }
 literal* end(const assignment& a) { return a.end(); }
 
-bool assignment::is_true(literal l) const { return is_assigned_true.get_copy(l); }
-bool assignment::is_false(literal l) const { return is_assigned_true.get_copy(-l); }
-bool assignment::is_unassigned(literal l) const {
-    return !this->is_true(l) && !this->is_false(l);
+// On a real assignment, the clause tests in cnf.h can read the value array
+// directly (and use the vector kernels).
+bool clause_sat(cnf::clause_iterator c, const assignment& a) {
+    return clause_scan::any_true(begin(c), end(c), a.values.first_value_iter());
 }
+bool clause_unsat(cnf::clause_iterator c, const assignment& a) {
+    return clause_scan::all_false(begin(c), end(c), a.values.first_value_iter());
+}
+literal clause_implies(cnf::clause_iterator c, const assignment& a) {
+    return clause_scan::implied(begin(c), end(c), a.values.first_value_iter());
+}
+
+bool assignment::is_true(literal l) const { return values[l] > 0; }
+bool assignment::is_false(literal l) const { return values[l] < 0; }
+bool assignment::is_unassigned(literal l) const { return values[l] == 0; }
 
 void assignment::push_decision(literal l) {
     ASSERT(is_unassigned(l));
-    is_assigned_true[l] = true;
+    values[l] = 1;
+    values[-l] = -1;
     Parent[assigned_count] = nullptr;
     left_right[assigned_count] = L;
     decision_sequence[assigned_count] = l;
+    trail_index[l] = assigned_count;
+    level_start[level] = assigned_count;
     assigned_count++;
     lit_dec_level[l] = level;
     level++;
@@ -259,30 +344,36 @@ void assignment::push_decision(literal l) {
 
 void assignment::push_implicant(literal l, cnf::clause_iterator reason) {
     ASSERT(is_unassigned(l));
-    is_assigned_true[l] = true;
+    values[l] = 1;
+    values[-l] = -1;
     Parent[assigned_count] = reason;
     left_right[assigned_count] = R;
     decision_sequence[assigned_count] = l;
+    trail_index[l] = assigned_count;
     assigned_count++;
     lit_dec_level[l] = level-1;
 }
 
+void assignment::push_implicant(literal l, cnf::clause_iterator reason, int at_level) {
+    ASSERT(at_level < level);
+    push_implicant(l, reason);
+    lit_dec_level[l] = at_level;
+    if (at_level < level-1) { out_of_order = true; }
+}
+
 // print out every field
 void assignment::print(std::ostream& o) const {
     for (int i = 0; i < assigned_count; ++i) {
         o << i << ": " << decision_sequence[i] << " = " <<
-                          is_assigned_true.get_copy(decision_sequence[i]) << "; " <<
+                          int(values[decision_sequence[i]]) << "; " <<
                           (left_right[i] == L ? "L" : "R") << " at level " <<
-                          lit_dec_level.get_copy(decision_sequence[i]);
+                          lit_dec_level[decision_sequence[i]];
         if (Parent[i]) o << " by (" << Parent[i] <<")";
         o << std::endl;
     }
-    for (literal i = is_assigned_true.first_index();
-         i != is_assigned_true.end_index();
-         ++i) {
-
-        if (i && is_assigned_true.get_copy(i)) {
-            o << i << " ";
+    for (unsigned i = values.first_index(); i != values.end_index(); ++i) {
+        if (is_true(literal(i))) {
+            o << literal(i) << " ";
         }
     }
 }
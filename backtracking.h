@@ -0,0 +1,27 @@
+#ifndef BACKTRACKING_H
+#define BACKTRACKING_H
+
+// Backtracking policies. After learning a clause whose second-highest
+// level is backjump, from a conflict at level, the solver asks the policy
+// which level to go back to. Anything at or above backjump is sound.
+
+// What we've always done: jump all the way.
+struct non_chronological_backtracking {
+    static const bool chronological = false;
+    int target(int, int backjump) const { return backjump; }
+};
+
+// Nadel and Ryvchin, "Chronological Backtracking" (SAT 2018): a long
+// jump throws away a lot of work that BCP will mostly just redo, so past
+// threshold levels we only undo the conflict level. The learned clause's
+// literal then lands on the trail below levels decided before it, so this
+// needs the solver's out-of-order trail handling (chronological == true).
+struct chronological_backtracking {
+    static const bool chronological = true;
+    const int threshold = 100;
+    int target(int level, int backjump) const {
+        return level - backjump > threshold ? level - 1 : backjump;
+    }
+};
+
+#endif
@@ -0,0 +1,250 @@
+#ifndef BLOCKED_H
+#define BLOCKED_H
+
+#include "cnf.h"
+
+#include <vector>
+#include <algorithm>
+
+// Blocked clause elimination (Jarvisalo, Biere and Heule, TACAS 2010), as
+// a preprocessing pass. Clause C is blocked on its literal l if every
+// resolvent on l, with each clause containing -l, is a tautology. Removing
+// C keeps the formula satisfiable: given a model of the rest that makes C
+// false, make l true instead. Each clause with -l has some other literal
+// whose negation is in C, so true, and stays satisfied. Tseitin encodings
+// are full of these: a gate whose output is only used one way round has
+// half its definition blocked.
+//
+// We keep occurrence lists (CSR style, as in renumber.h) and a queue of
+// touched literals. Removing C only makes a difference to the clauses
+// that resolved with it, the ones with the negation of one of its
+// literals, so those literals are what we look at next.
+//
+// With covered, clauses that aren't blocked get covered literal addition
+// first (Heule, Jarvisalo and Biere, LPAR 2010). The literals common to
+// every non-tautological resolvent on l (besides -l) can be added to C,
+// as l can always be flipped to satisfy C again, and the bigger clause
+// may be blocked.
+//
+// Each removal goes on a reconstruction stack as (clause, literal to
+// flip), after its covered literal additions. extend() goes over the
+// stack backwards and turns a model of what's left into one of the input.
+class blocked_clause_elimination {
+    // The clauses containing literal l are occ[occ_start[l] .. occ_start[l+1]].
+    std::vector<int> occ_start, occ;
+    std::vector<char> removed;
+
+    // The literals of the clause we're looking at are marked with stamp;
+    // the other clause of a resolvent, with other_stamp.
+    std::vector<unsigned> mark, other_mark;
+    unsigned stamp = 0, other_stamp = 0;
+
+    std::vector<literal> queue;
+    std::vector<char> queued;
+
+    // The stack: the literals of each entry, and where they end and which
+    // one to flip.
+    struct entry {
+        int finish;
+        literal flip;
+    };
+    std::vector<literal> stack_literals;
+    std::vector<entry> stack;
+
+    // Resolution checks are quadratic in the occurrence lists, so we stop
+    // after a budget of literals visited.
+    long steps = 0;
+    const long max_steps;
+
+    int occurrences(literal l) const { return occ_start[l.index() + 1] - occ_start[l.index()]; }
+
+    template<typename It>
+    void mark_clause(It b, It e) {
+        ++stamp;
+        for (; b != e; ++b) { mark[b->index()] = stamp; }
+    }
+    bool marked(literal l) const { return mark[l.index()] == stamp; }
+
+    // Whether clause d's resolvent on -l with the marked clause has a
+    // complementary pair.
+    bool tautology(cnf::clause_iterator d, literal l) {
+        for (literal x : d) {
+            steps++;
+            if (x != -l && marked(-x)) { return true; }
+        }
+        return false;
+    }
+
+    bool blocked_on(const cnf& c, literal l) {
+        for (int i = occ_start[(-l).index()]; i < occ_start[(-l).index() + 1]; ++i) {
+            if (removed[occ[i]]) { continue; }
+            if (!tautology(c.clause_begin() + occ[i], l)) { return false; }
+        }
+        return true;
+    }
+
+    void enqueue(literal l) {
+        if (queued[l.index()]) { return; }
+        queued[l.index()] = 1;
+        queue.push_back(l);
+    }
+
+    template<typename It>
+    void push(It b, It e, literal flip) {
+        stack_literals.insert(stack_literals.end(), b, e);
+        stack.push_back({int(stack_literals.size()), flip});
+    }
+
+    void remove(cnf::clause_iterator cit, int ci) {
+        removed[ci] = 1;
+        for (literal x : cit) { enqueue(-x); }
+    }
+
+    // Clauses containing a queued literal, blocked on it, until there's
+    // nothing left to look at.
+    void eliminate_blocked(const cnf& c) {
+        while (!queue.empty() && steps < max_steps) {
+            const literal l = queue.back();
+            queue.pop_back();
+            queued[l.index()] = 0;
+            for (int i = occ_start[l.index()]; i < occ_start[l.index() + 1]; ++i) {
+                const int ci = occ[i];
+                if (removed[ci]) { continue; }
+                auto cit = c.clause_begin() + ci;
+                mark_clause(cit->start, cit->finish);
+                if (!blocked_on(c, l)) { continue; }
+                push(cit->start, cit->finish, l);
+                remove(cit, ci);
+                blocked++;
+            }
+        }
+    }
+
+    // Covered literal addition on clause ci until it's blocked (true; it's
+    // been removed) or there's nothing more to add.
+    std::vector<literal> extended, common;
+    std::vector<std::pair<int, literal>> additions; // (size before, on literal)
+    bool eliminate_covered(const cnf& c, int ci) {
+        auto cit = c.clause_begin() + ci;
+        extended.assign(cit->start, cit->finish);
+        mark_clause(extended.begin(), extended.end());
+        additions.clear();
+        const size_t max_size = 2 * extended.size() + 16;
+        bool changed = true;
+        while (changed && steps < max_steps) {
+            changed = false;
+            for (size_t i = 0; i < extended.size(); ++i) {
+                const literal l = extended[i];
+                bool any = false;
+                for (int j = occ_start[(-l).index()]; j < occ_start[(-l).index() + 1]; ++j) {
+                    if (removed[occ[j]]) { continue; }
+                    auto d = c.clause_begin() + occ[j];
+                    if (tautology(d, l)) { continue; }
+                    if (!any) {
+                        any = true;
+                        common.clear();
+                        for (literal x : d) {
+                            if (x != -l && !marked(x)) { common.push_back(x); }
+                        }
+                    }
+                    else {
+                        ++other_stamp;
+                        for (literal x : d) { other_mark[x.index()] = other_stamp; }
+                        common.erase(std::remove_if(common.begin(), common.end(), [&](literal x) {
+                            return other_mark[x.index()] != other_stamp;
+                        }), common.end());
+                    }
+                    if (common.empty()) { break; }
+                }
+                if (!any) {
+                    for (auto a : additions) {
+                        push(extended.begin(), extended.begin() + a.first, a.second);
+                    }
+                    push(extended.begin(), extended.end(), l);
+                    remove(cit, ci);
+                    covered++;
+                    return true;
+                }
+                if (common.empty() || extended.size() + common.size() > max_size) { continue; }
+                additions.push_back({int(extended.size()), l});
+                for (literal x : common) {
+                    extended.push_back(x);
+                    mark[x.index()] = stamp;
+                }
+                changed = true;
+            }
+        }
+        return false;
+    }
+
+public:
+    long blocked = 0, covered = 0;
+
+    blocked_clause_elimination(const cnf& c, bool with_covered):
+        occ_start(c.max_literal_count + 3, 0),
+        removed(c.clauses_count, 0),
+        mark(c.max_literal_count + 2, 0),
+        other_mark(c.max_literal_count + 2, 0),
+        queued(c.max_literal_count + 2, 0),
+        max_steps(20l * c.raw_data_count + 1000000)
+    {
+        for (auto cit = c.clause_begin(); cit != c.clause_end(); ++cit) {
+            for (literal l : cit) { occ_start[l.index() + 1]++; }
+        }
+        for (size_t i = 1; i < occ_start.size(); ++i) { occ_start[i] += occ_start[i - 1]; }
+        occ.resize(occ_start.back());
+        std::vector<int> fill(occ_start.begin(), occ_start.end() - 1);
+        for (int ci = 0; ci < c.clauses_count; ++ci) {
+            for (literal l : c.clause_begin() + ci) { occ[fill[l.index()]++] = ci; }
+        }
+
+        // Cheapest first: the literals whose negations occur least are at
+        // the back of the queue.
+        std::vector<literal> literals;
+        for (int v = 1; v <= c.max_literal_count / 2; ++v) {
+            literals.push_back(literal::positive(v));
+            literals.push_back(-literal::positive(v));
+        }
+        std::stable_sort(literals.begin(), literals.end(), [&](literal x, literal y) {
+            return occurrences(-x) > occurrences(-y);
+        });
+        for (literal l : literals) { enqueue(l); }
+        eliminate_blocked(c);
+
+        if (!with_covered) { return; }
+        for (int ci = 0; ci < c.clauses_count && steps < max_steps; ++ci) {
+            if (removed[ci]) { continue; }
+            if (eliminate_covered(c, ci)) { eliminate_blocked(c); }
+        }
+    }
+
+    // A copy of c without the removed clauses.
+    cnf apply(const cnf& c) const {
+        cnf result(c.raw_data_max, c.clauses_max, c.max_literal_count);
+        for (auto cit = c.clause_begin(); cit != c.clause_end(); ++cit) {
+            if (removed[cit - c.clause_begin()]) { continue; }
+            result.insert_clause(*cit);
+        }
+        return result;
+    }
+
+    // A model of the reduced formula (with variables it doesn't mention
+    // taken as true, as print_model does) as one of the input.
+    std::vector<literal> extend(const std::vector<literal>& model, int variables) const {
+        std::vector<literal> value(variables + 1);
+        for (int v = 1; v <= variables; ++v) { value[v] = literal::positive(v); }
+        for (literal l : model) { value[l.var()] = l; }
+        for (size_t i = stack.size(); i-- > 0; ) {
+            const int start = i ? stack[i - 1].finish : 0;
+            bool satisfied = false;
+            for (int j = start; j < stack[i].finish && !satisfied; ++j) {
+                const literal l = stack_literals[j];
+                satisfied = value[l.var()] == l;
+            }
+            if (!satisfied) { value[stack[i].flip.var()] = stack[i].flip; }
+        }
+        return std::vector<literal>(value.begin() + 1, value.end());
+    }
+};
+
+#endif
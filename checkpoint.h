@@ -0,0 +1,283 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "cnf.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Snapshots of a search, so a later run can carry on with what this one
+// learned. A snapshot file is
+//     "satsnap1", the configuration's name, the body, and a checksum
+// and the body is
+//     the number of variables
+//     the clauses, learned ones included, then the literals fixed at the
+//       root as unit clauses (count, total literals, and each clause's
+//       size and literals)
+//     the state of the reduction policy (LBDs), the heuristic (scores,
+//       queue order, saved phases) and the restart policy, each as it
+//       wrote it with its save()
+// Numbers are in the variable-length encoding of binary DRAT (proof.h),
+// doubles as their 8 bytes. The checksum (FNV-1a) is there so a file cut
+// short by a crash is turned down up front rather than half-loaded.
+
+// Pass the hash so far as h to carry on from it.
+inline unsigned long fnv1a(const char* b, const char* e, unsigned long h = 14695981039346656037ul) {
+    for (; b != e; ++b) {
+        h ^= static_cast<unsigned char>(*b);
+        h *= 1099511628211ul;
+    }
+    return h;
+}
+
+class checkpoint_writer {
+public:
+    std::vector<char> bytes;
+
+    void put_number(unsigned long x) {
+        while (x > 127) {
+            bytes.push_back(static_cast<char>((x & 127) | 128));
+            x >>= 7;
+        }
+        bytes.push_back(static_cast<char>(x));
+    }
+    void put_signed(long x) {
+        put_number(x < 0 ? (2ul * -x) + 1 : 2ul * x);
+    }
+    void put_double(double x) {
+        char raw[sizeof(double)];
+        memcpy(raw, &x, sizeof(double));
+        bytes.insert(bytes.end(), raw, raw + sizeof(double));
+    }
+    void put_string(const std::string& s) {
+        put_number(s.size());
+        bytes.insert(bytes.end(), s.begin(), s.end());
+    }
+};
+
+// Reads a whole snapshot file: the header and checksum are checked on
+// construction (ok is false if they're wrong), and the body is read in
+// order. Reading past the end just gives zeros and clears ok.
+class checkpoint_reader {
+    const char* at;
+    const char* end;
+
+    bool need(size_t n) {
+        if (size_t(end - at) >= n) { return true; }
+        ok = false;
+        at = end;
+        return false;
+    }
+
+public:
+    bool ok = true;
+    std::string config;
+
+    checkpoint_reader(const char* b, const char* e): at(b), end(e) {
+        const size_t tail = sizeof(unsigned long);
+        if (e - b < 8 + long(tail) || memcmp(b, "satsnap1", 8)) {
+            ok = false;
+            return;
+        }
+        unsigned long sum;
+        memcpy(&sum, e - tail, tail);
+        end = e - tail;
+        if (fnv1a(b, end) != sum) {
+            ok = false;
+            return;
+        }
+        at += 8;
+        config = get_string();
+    }
+
+    unsigned long get_number() {
+        unsigned long x = 0;
+        for (int shift = 0; need(1) && shift < 64; shift += 7) {
+            const unsigned char c = *at++;
+            x |= (unsigned long)(c & 127) << shift;
+            if (!(c & 128)) { return x; }
+        }
+        ok = false;
+        return 0;
+    }
+    long get_signed() {
+        const unsigned long x = get_number();
+        return (x & 1) ? -long(x >> 1) : long(x >> 1);
+    }
+    double get_double() {
+        double x = 0;
+        if (need(sizeof(double))) {
+            memcpy(&x, at, sizeof(double));
+            at += sizeof(double);
+        }
+        return x;
+    }
+    std::string get_string() {
+        const unsigned long n = get_number();
+        if (!need(n)) { return std::string(); }
+        std::string s(at, n);
+        at += n;
+        return s;
+    }
+    // A count of things that take at least a byte each: anything more than
+    // what's left is a broken file, not a reason to allocate.
+    unsigned long get_count() {
+        const unsigned long n = get_number();
+        if (n > size_t(end - at)) {
+            ok = false;
+            at = end;
+            return 0;
+        }
+        return n;
+    }
+    bool at_end() const { return at == end; }
+};
+
+// The formula part of the body; units are the root-level literals that
+// aren't already unit clauses of c.
+void put_formula(checkpoint_writer& out, const cnf& c, const std::vector<literal>& units) {
+    // (The arena can have gaps in it after a reduction.)
+    long literals = units.size();
+    for (auto cit = c.clause_begin(); cit != c.clause_end(); ++cit) { literals += size(cit); }
+    out.put_number(c.max_literal_count / 2);
+    out.put_number(c.clauses_count + units.size());
+    out.put_number(literals);
+    for (auto cit = c.clause_begin(); cit != c.clause_end(); ++cit) {
+        out.put_number(size(cit));
+        for (literal l : cit) { out.put_number(l.index()); }
+    }
+    for (literal l : units) {
+        out.put_number(1);
+        out.put_number(l.index());
+    }
+}
+
+cnf get_formula(checkpoint_reader& in) {
+    const unsigned long variables = in.get_count();
+    const unsigned long clauses = in.get_count();
+    const unsigned long literals = in.get_count();
+    cnf result(std::max(literals, 1ul), std::max(clauses, 1ul), 2 * variables);
+    std::vector<literal> clause;
+    for (unsigned long i = 0; i < clauses && in.ok; ++i) {
+        clause.clear();
+        const unsigned long n = in.get_count();
+        for (unsigned long j = 0; j < n; ++j) {
+            const literal l(in.get_number());
+            if (l.var() < 1 || (unsigned long)l.var() > variables) {
+                in.ok = false;
+                break;
+            }
+            clause.push_back(l);
+        }
+        if (!in.ok || result.remaining_size() < int(clause.size()) || !result.remaining_clauses()) {
+            in.ok = false;
+            break;
+        }
+        result.insert_clause(clause);
+    }
+    return result;
+}
+
+// Writes snapshots to path on a thread of its own, so the search only pays
+// for putting them together. Each goes to path.tmp first and is renamed
+// over path once it's all there, so there's always a whole one on disk. If
+// the search hands over a new snapshot before the last has been started
+// on, the new one replaces it. finish() (or the destructor) waits for the
+// last write.
+class checkpointer {
+    typedef std::chrono::steady_clock clock;
+
+    const std::string path;
+    const std::string config;
+    const double interval;
+    clock::time_point last = clock::now();
+    unsigned long calls = 0;
+
+    std::vector<char> pending;
+    bool has_pending = false;
+    bool done = false;
+    std::mutex m;
+    std::condition_variable cv;
+    std::thread worker;
+
+    bool write(const std::vector<char>& body) {
+        checkpoint_writer header;
+        header.bytes.assign("satsnap1", "satsnap1" + 8);
+        header.put_string(config);
+        const unsigned long sum = fnv1a(body.data(), body.data() + body.size(),
+                                        fnv1a(header.bytes.data(), header.bytes.data() + header.bytes.size()));
+        const std::string tmp = path + ".tmp";
+        FILE* f = fopen(tmp.c_str(), "wb");
+        if (!f) { return false; }
+        bool ok = fwrite(header.bytes.data(), 1, header.bytes.size(), f) == header.bytes.size() &&
+                  fwrite(body.data(), 1, body.size(), f) == body.size() &&
+                  fwrite(&sum, sizeof(sum), 1, f) == 1;
+        ok = (fclose(f) == 0) && ok;
+        return ok && rename(tmp.c_str(), path.c_str()) == 0;
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(m);
+        for (;;) {
+            cv.wait(lock, [&]() { return has_pending || done; });
+            if (!has_pending) { return; }
+            std::vector<char> body;
+            std::swap(body, pending);
+            has_pending = false;
+            lock.unlock();
+            const auto started = clock::now();
+            const bool ok = write(body);
+            const double t = std::chrono::duration<double>(clock::now() - started).count();
+            lock.lock();
+            write_seconds += t;
+            if (ok) { written++; } else { failed++; }
+        }
+    }
+
+public:
+    // Read these after finish().
+    long written = 0, failed = 0;
+    double write_seconds = 0;
+
+    checkpointer(const char* path, const char* config, double interval):
+        path(path), config(config), interval(interval),
+        worker(&checkpointer::run, this)
+    {}
+
+    ~checkpointer() { finish(); }
+
+    void finish() {
+        if (!worker.joinable()) { return; }
+        {
+            std::unique_lock<std::mutex> lock(m);
+            done = true;
+            cv.notify_all();
+        }
+        worker.join();
+    }
+
+    // Called after each conflict: whether it's time for another snapshot.
+    // We only look at the clock every 256 calls.
+    bool due() {
+        if (++calls & 255) { return false; }
+        const auto now = clock::now();
+        if (std::chrono::duration<double>(now - last).count() < interval) { return false; }
+        last = now;
+        return true;
+    }
+
+    void save(std::vector<char>&& body) {
+        std::unique_lock<std::mutex> lock(m);
+        pending = std::move(body);
+        has_pending = true;
+        cv.notify_all();
+    }
+};
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef CLAUSE_EXCHANGE_H
+#define CLAUSE_EXCHANGE_H
+
+#include "cnf.h"
+#include "checkpoint.h"
+#include "generators.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Learned clauses carried over from one run to the next, for warm starts
+// on instances that change a little from day to day. At the end of a run
+// we write out the learned clauses with LBD and size under a limit; a
+// later run reads them back in as learned clauses, that reduction can
+// throw away like any others.
+//
+// They're only implied by the formula they were learned from, so we
+// record a hash of its clauses. If the new formula's differs, the clauses
+// are only safe if all the old clauses are still in it (it's only gained
+// some), which is for whoever's asking to say.
+//
+// The file is DIMACS, so anything can read it, sorted by LBD, with
+//     c hash H    the hash of the formula they're from
+//     c lbd N     for the clauses after it
+
+// A hash of c's clauses as a set: each clause's literals are sorted and
+// hashed, and the hashes summed, so neither the order of the clauses nor
+// of their literals matters.
+unsigned long clause_set_hash(const cnf& c) {
+    unsigned long sum = c.max_literal_count;
+    std::vector<unsigned> indices;
+    for (auto cit = c.clause_begin(); cit != c.clause_end(); ++cit) {
+        indices.clear();
+        for (literal l : cit) { indices.push_back(l.index()); }
+        std::sort(indices.begin(), indices.end());
+        const char* b = reinterpret_cast<const char*>(indices.data());
+        sum += fnv1a(b, b + indices.size() * sizeof(unsigned));
+    }
+    return sum;
+}
+
+class learned_export {
+    const int max_lbd, max_size;
+    std::vector<std::pair<int, std::vector<int>>> clauses; // (LBD, sorted DIMACS literals)
+
+public:
+    learned_export(int max_lbd, int max_size): max_lbd(max_lbd), max_size(max_size) {}
+
+    // An LBD of 0 means it's not a learned clause.
+    void consider(int lbd, cnf::clause_iterator cit) {
+        if (lbd < 1 || lbd > max_lbd || size(cit) > max_size) { return; }
+        std::vector<int> lits;
+        for (literal l : cit) { lits.push_back(l.to_dimacs()); }
+        std::sort(lits.begin(), lits.end());
+        clauses.push_back({lbd, std::move(lits)});
+    }
+
+    // Returns how many clauses we wrote (duplicates only once, with the
+    // lowest LBD any of them had).
+    long write(FILE* f, unsigned long hash, int variables) {
+        std::sort(clauses.begin(), clauses.end(), [](const auto& x, const auto& y) {
+            return x.second != y.second ? x.second < y.second : x.first < y.first;
+        });
+        clauses.erase(std::unique(clauses.begin(), clauses.end(), [](const auto& x, const auto& y) {
+            return x.second == y.second;
+        }), clauses.end());
+        std::sort(clauses.begin(), clauses.end());
+        dimacs_sink out(f);
+        out.comment(("hash " + std::to_string(hash)).c_str());
+        out.header(variables, clauses.size());
+        int lbd = 0;
+        for (const auto& cl : clauses) {
+            if (cl.first != lbd) {
+                lbd = cl.first;
+                out.comment(("lbd " + std::to_string(lbd)).c_str());
+            }
+            out.clause(cl.second);
+        }
+        return clauses.size();
+    }
+};
+
+// Reads what learned_export wrote. ok is false if it doesn't look like
+// that (no hash, a literal out of range, a clause without its 0).
+struct learned_import {
+    bool ok = true;
+    unsigned long hash = 0;
+    int variables = 0;
+    std::vector<std::pair<int, std::vector<literal>>> clauses; // (LBD, literals)
+
+    learned_import(std::istream& in) {
+        bool has_hash = false;
+        int lbd = 1;
+        std::string line;
+        while (getline(in, line)) {
+            auto words = std::istringstream(line);
+            std::string first;
+            if (!(words >> first)) { continue; }
+            if (first == "c") {
+                std::string key;
+                words >> key;
+                if (key == "hash") { has_hash = bool(words >> hash); }
+                else if (key == "lbd") { words >> lbd; }
+                continue;
+            }
+            if (first == "p") {
+                std::string format;
+                words >> format >> variables;
+                continue;
+            }
+            std::vector<literal> clause;
+            words = std::istringstream(line);
+            int x;
+            bool ended = false;
+            while (words >> x) {
+                if (x == 0) {
+                    ended = true;
+                    break;
+                }
+                if (std::abs(x) > variables) { ok = false; }
+                clause.push_back(literal::from_dimacs(x));
+            }
+            if (!ended || clause.empty()) { ok = false; }
+            clauses.push_back({std::max(lbd, 1), std::move(clause)});
+        }
+        ok = ok && has_hash;
+    }
+};
+
+#endif
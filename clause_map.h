@@ -3,6 +3,7 @@
 
 #include "debug.h"
 #include "cnf.h"
+#include "page_alloc.h"
 
 
 // Basically, maps clause_iterator -> T.
@@ -14,12 +15,12 @@ private:
     int size;
     typedef cnf::clause_iterator key_t;
     key_t offset;
-    std::unique_ptr<T[]> data;
+    big_array<T> data;
 
     void on_resize(cnf::clause_iterator old_base,
                    cnf::clause_iterator new_base,
                    int new_size) {
-        auto new_data = std::make_unique<T[]>(new_size);
+        auto new_data = make_big_array<T>(new_size);
 
         for (int i = 0; i < size; ++i) {
             new_data[i] = data[i];
@@ -48,7 +49,7 @@ public:
     clause_map(cnf& c, const int size, const key_t offset):
         size(size),
         offset(offset),
-        data(std::make_unique<T[]>(size))
+        data(make_big_array<T>(size))
     {
         using namespace std::placeholders;
         // Register ourselves as needing a remap:
@@ -0,0 +1,197 @@
+#ifndef CLAUSE_SCAN_H
+#define CLAUSE_SCAN_H
+
+#include "literal_map.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CLAUSE_SCAN_AVX2
+#include <immintrin.h>
+#endif
+
+// The loops that walk a clause's literals against the assignment: finding
+// a replacement watch, and the sat/unsat/unit tests. They read the value
+// array directly (1 true, -1 false, 0 unassigned, indexed by literal code).
+//
+// With AVX2 we take 8 literals at a time: since the codes are the indices,
+// one gather pulls in their 8 values, and a compare plus movemask says
+// which are true/false. Learned clauses are where this pays off; short
+// clauses (and the tail of long ones) stay scalar. SSE4 has no gather, so
+// there's no point having a version for it. Which one we use is decided
+// once, by CPUID; each vector kernel must give exactly the scalar answer
+// (see tests/clause_scan_test.cpp).
+namespace clause_scan {
+
+// Below this many literals the setup isn't worth it.
+const long vector_min = 8;
+
+namespace scalar {
+    // The first true literal other than w1 and w2, or failing that, the
+    // first unassigned one. No literal if there's neither.
+    literal find_replacement(const literal* b, const literal* e, const signed char* values,
+                             literal w1, literal w2) {
+        literal safe_lit;
+        for (; b != e; ++b) {
+            literal x = *b;
+            if (x == w1 || x == w2) { continue; }
+            signed char v = values[x.index()];
+            if (v > 0) { return x; }
+            if (!safe_lit && v == 0) { safe_lit = x; }
+        }
+        return safe_lit;
+    }
+
+    bool any_true(const literal* b, const literal* e, const signed char* values) {
+        for (; b != e; ++b) {
+            if (values[b->index()] > 0) { return true; }
+        }
+        return false;
+    }
+
+    bool all_false(const literal* b, const literal* e, const signed char* values) {
+        for (; b != e; ++b) {
+            if (values[b->index()] >= 0) { return false; }
+        }
+        return true;
+    }
+
+    // The clause's only unassigned literal, if nothing in it is true.
+    literal implied(const literal* b, const literal* e, const signed char* values) {
+        literal unit;
+        for (; b != e; ++b) {
+            signed char v = values[b->index()];
+            if (v > 0) { return literal(); }
+            if (v == 0) {
+                if (unit) { return literal(); }
+                unit = *b;
+            }
+        }
+        return unit;
+    }
+}
+
+#ifdef CLAUSE_SCAN_AVX2
+namespace avx2 {
+    // Each literal's value, sign-extended to 32 bits. The gather reads 4
+    // bytes at each index, hence the slack at the end of literal_map.
+    __attribute__((target("avx2")))
+    __m256i values_of(__m256i codes, const signed char* values) {
+        __m256i v = _mm256_i32gather_epi32(reinterpret_cast<const int*>(values), codes, 1);
+        return _mm256_srai_epi32(_mm256_slli_epi32(v, 24), 24);
+    }
+    __attribute__((target("avx2")))
+    unsigned mask_of(__m256i m) {
+        return _mm256_movemask_ps(_mm256_castsi256_ps(m));
+    }
+    __attribute__((target("avx2")))
+    __m256i load(const literal* p) {
+        static_assert(sizeof(literal) == 4, "literals are gathered as 32-bit indices");
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+
+    __attribute__((target("avx2")))
+    literal find_replacement(const literal* b, const literal* e, const signed char* values,
+                             literal w1, literal w2) {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i ws1 = _mm256_set1_epi32(w1.index());
+        const __m256i ws2 = _mm256_set1_epi32(w2.index());
+        literal safe_lit;
+        for (; e - b >= 8; b += 8) {
+            __m256i codes = load(b);
+            __m256i v = values_of(codes, values);
+            unsigned watched = mask_of(_mm256_or_si256(_mm256_cmpeq_epi32(codes, ws1),
+                                                       _mm256_cmpeq_epi32(codes, ws2)));
+            unsigned is_true = mask_of(_mm256_cmpgt_epi32(v, zero)) & ~watched;
+            if (is_true) { return b[__builtin_ctz(is_true)]; }
+            if (!safe_lit) {
+                unsigned unassigned = mask_of(_mm256_cmpeq_epi32(v, zero)) & ~watched;
+                if (unassigned) { safe_lit = b[__builtin_ctz(unassigned)]; }
+            }
+        }
+        for (; b != e; ++b) {
+            literal x = *b;
+            if (x == w1 || x == w2) { continue; }
+            signed char v = values[x.index()];
+            if (v > 0) { return x; }
+            if (!safe_lit && v == 0) { safe_lit = x; }
+        }
+        return safe_lit;
+    }
+
+    __attribute__((target("avx2")))
+    bool any_true(const literal* b, const literal* e, const signed char* values) {
+        const __m256i zero = _mm256_setzero_si256();
+        for (; e - b >= 8; b += 8) {
+            if (mask_of(_mm256_cmpgt_epi32(values_of(load(b), values), zero))) { return true; }
+        }
+        return scalar::any_true(b, e, values);
+    }
+
+    __attribute__((target("avx2")))
+    bool all_false(const literal* b, const literal* e, const signed char* values) {
+        const __m256i zero = _mm256_setzero_si256();
+        for (; e - b >= 8; b += 8) {
+            if (mask_of(_mm256_cmpgt_epi32(zero, values_of(load(b), values))) != 0xff) { return false; }
+        }
+        return scalar::all_false(b, e, values);
+    }
+
+    __attribute__((target("avx2")))
+    literal implied(const literal* b, const literal* e, const signed char* values) {
+        const __m256i zero = _mm256_setzero_si256();
+        literal unit;
+        for (; e - b >= 8; b += 8) {
+            __m256i v = values_of(load(b), values);
+            if (mask_of(_mm256_cmpgt_epi32(v, zero))) { return literal(); }
+            unsigned unassigned = mask_of(_mm256_cmpeq_epi32(v, zero));
+            if (!unassigned) { continue; }
+            if (unit || (unassigned & (unassigned - 1))) { return literal(); }
+            unit = b[__builtin_ctz(unassigned)];
+        }
+        for (; b != e; ++b) {
+            signed char v = values[b->index()];
+            if (v > 0) { return literal(); }
+            if (v == 0) {
+                if (unit) { return literal(); }
+                unit = *b;
+            }
+        }
+        return unit;
+    }
+}
+
+bool detect_avx2() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+// Not const, so tests and microbench can force the scalar path.
+bool use_avx2 = detect_avx2();
+#else
+bool use_avx2 = false;
+#endif
+
+#ifdef CLAUSE_SCAN_AVX2
+#define CLAUSE_SCAN_DISPATCH(kernel, ...)                        \
+    if (use_avx2 && e - b >= vector_min) { return avx2::kernel(__VA_ARGS__); } \
+    return scalar::kernel(__VA_ARGS__);
+#else
+#define CLAUSE_SCAN_DISPATCH(kernel, ...) return scalar::kernel(__VA_ARGS__);
+#endif
+
+literal find_replacement(const literal* b, const literal* e, const signed char* values,
+                         literal w1, literal w2) {
+    CLAUSE_SCAN_DISPATCH(find_replacement, b, e, values, w1, w2)
+}
+bool any_true(const literal* b, const literal* e, const signed char* values) {
+    CLAUSE_SCAN_DISPATCH(any_true, b, e, values)
+}
+bool all_false(const literal* b, const literal* e, const signed char* values) {
+    CLAUSE_SCAN_DISPATCH(all_false, b, e, values)
+}
+literal implied(const literal* b, const literal* e, const signed char* values) {
+    CLAUSE_SCAN_DISPATCH(implied, b, e, values)
+}
+
+#undef CLAUSE_SCAN_DISPATCH
+}
+
+#endif
@@ -2,12 +2,17 @@
 #define CNF_TABLE_H
 
 #include "literal_map.h"
+#include "page_alloc.h"
 #include "small_set.h"
+#include "stamped_set.h"
 #include "debug.h"
+#include "profiler.h"
 
 #include <memory>
 #include <iostream>
 #include <algorithm>
+#include <functional>
+#include <vector>
 
 class cnf {
 public:
@@ -25,8 +30,8 @@ public:
     int clauses_max;
     int clauses_count = 0;
 
-    std::unique_ptr<literal[]> raw_data;
-    std::unique_ptr<clause[]> clauses;
+    big_array<literal> raw_data;
+    big_array<clause> clauses;
     // If a datatype wants to register for when we remap our clause array...
     std::vector<std::function<void(clause_iterator,clause_iterator,int)>> resizers;
     std::vector<std::function<void(int*, int, clause_iterator)>> remappers;
@@ -35,8 +40,8 @@ public:
         max_literal_count(LiteralCount),
         raw_data_max(MaxSize),
         clauses_max(ClauseCount),
-        raw_data(std::make_unique<literal[]>(MaxSize)),
-        clauses(std::make_unique<clause[]>(ClauseCount))
+        raw_data(make_big_array<literal>(MaxSize)),
+        clauses(make_big_array<clause>(ClauseCount))
     {}
 
 
@@ -97,7 +102,7 @@ public:
     void resize_raw_data() {
         auto base = raw_data.get();
         int new_size = raw_data_max * 2;
-        std::unique_ptr<literal[]> new_data = std::make_unique<literal[]>(new_size);
+        big_array<literal> new_data = make_big_array<literal>(new_size);
         for (int i = 0; i < raw_data_count; ++i) {
             new_data[i] = raw_data[i];
         }
@@ -117,7 +122,7 @@ public:
     // This invalidates any ckeys that may exist "in the wild".
     void resize_clauses() {
         int new_size = clauses_max * 2;
-        std::unique_ptr<clause[]> new_data = std::make_unique<clause[]>(new_size);
+        big_array<clause> new_data = make_big_array<clause>(new_size);
 
         // copy the data over...
         for (int i = 0; i < clauses_count; ++i) {
@@ -145,6 +150,7 @@ public:
     }
 
     void remap_clauses(int* m, int new_clause_count) {
+        PROFILE_SCOPE(phase_remap);
         for (auto cit = clause_begin(); cit != clause_end(); ++cit) {
             int old_index = cit - clause_begin();
             int new_index = m[old_index];
@@ -180,18 +186,25 @@ bool clause_contains(cnf::clause_iterator cit, literal l) {
 // we resolve many others. So it's useful to have a clause
 // that can grow or shrink as needed. Note that it can't
 // be bigger than #literals.
+// The literals are also marked in a bitset, so contains() (which
+// has_uip asks of every literal at the conflict level) is O(1).
 class flexsize_clause {
     public:
     std::unique_ptr<literal[]> raw_data;
     cnf::clause my_clause;
+    private:
+    literal_bitset members;
     public:
     flexsize_clause(const cnf& c):
         raw_data(std::make_unique<literal[]>(c.max_literal_count)),
-        my_clause{raw_data.get(), raw_data.get()}
+        my_clause{raw_data.get(), raw_data.get()},
+        members(c.max_literal_count)
     {}
     void adopt(cnf::clause_iterator c) {
         TRACE("Adopting: ", c, "\n");
+        clear();
         my_clause.finish = std::copy(c->start, c->finish, my_clause.start);
+        for (literal l : c) { members.insert(l); }
     }
     void resolve(cnf::clause_iterator c, literal l) {
         TRACE(*this, " ", c, " :  ", l, "\n");
@@ -201,29 +214,33 @@ class flexsize_clause {
         std::for_each(begin(c), end(c), [&](literal r) {
             if (r == -l) { return; }
             if (contains(r)) { return; }
+            members.insert(r);
             *my_clause.finish = r;
             my_clause.finish++;
         });
     }
 
-    bool contains(literal l) const {
-        return std::find(begin(my_clause), end(my_clause), l) != end(my_clause);
-    }
+    bool contains(literal l) const { return members.contains(l); }
     void erase(literal l) {
         ASSERT(contains(l));
         auto it = std::find(begin(my_clause), end(my_clause), l);
         ASSERT(it != end(my_clause));
         ASSERT(std::find(std::next(it), end(my_clause), l) == end(my_clause));
+        members.erase(l);
         my_clause.finish--;
         std::swap(*it, *my_clause.finish);
     }
     void insert(literal l) {
         ASSERT(!contains(l));
+        members.insert(l);
         *my_clause.finish = l;
         my_clause.finish++;
     }
     int size() { return my_clause.finish - my_clause.start; }
-    void clear() { my_clause.finish = my_clause.start; }
+    void clear() {
+        for (auto it = my_clause.start; it != my_clause.finish; ++it) { members.erase(*it); }
+        my_clause.finish = my_clause.start;
+    }
 };
 
 std::ostream& operator<<(std::ostream& o, const flexsize_clause& c) {
@@ -295,8 +312,8 @@ auto has_conflict(const cnf& c, const A& a) {
 // Absolutely dead-stupid way of finding unit clauses...
 template<typename C, typename A>
 literal clause_implies(const C& c, const A& a) {
-    if (clause_sat(c, a)) { return 0; }
-    if (clause_unsat(c, a)) { return 0; }
+    if (clause_sat(c, a)) { return literal(); }
+    if (clause_unsat(c, a)) { return literal(); }
 
     auto l_ptr = std::find_if(begin(c), end(c), [&](literal l) {
         return a.is_unassigned(l);
@@ -306,19 +323,19 @@ literal clause_implies(const C& c, const A& a) {
     });
     ASSERT(l_ptr != end(c));
     if (nextl == end(c)) { return *l_ptr; }
-    return 0;
+    return literal();
 }
 
 template<typename C, typename A>
 std::pair<literal, cnf::clause_iterator> find_unit(const C& c, const A& a) {
     auto implying_clause = std::find_if(begin(c), end(c), [&](const auto& cl) {
-        return clause_implies(cl, a) != 0;
+        return bool(clause_implies(cl, a));
     });
     if (implying_clause != end(c)) {
         literal implied = clause_implies(implying_clause, a);
         return std::make_pair(implied, implying_clause);
     }
-    return std::make_pair(0, nullptr);
+    return std::make_pair(literal(), nullptr);
 }
 
 // Printing statements, mainly for debugging.
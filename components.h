@@ -0,0 +1,274 @@
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include "cnf.h"
+#include "solver.h"
+#include "stats.h"
+#include "page_alloc.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
+// Union-find over variables 1..n, with path halving and union by size.
+class disjoint_sets {
+    std::vector<int> parent, size;
+
+public:
+    disjoint_sets(int n): parent(n + 1), size(n + 1, 1) {
+        std::iota(parent.begin(), parent.end(), 0);
+    }
+    int find(int x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+    void unite(int x, int y) {
+        x = find(x);
+        y = find(y);
+        if (x == y) { return; }
+        if (size[x] < size[y]) { std::swap(x, y); }
+        parent[y] = x;
+        size[x] += size[y];
+    }
+};
+
+// A piece of the input: its clauses with the variables numbered 1..n, and
+// what each is called in the input (names[0] unused).
+struct component {
+    cnf formula;
+    std::vector<int> names;
+
+    literal to_input(literal l) const {
+        literal p = literal::positive(names[l.var()]);
+        return l.is_negative() ? -p : p;
+    }
+};
+
+// Unit propagation at the root (c's unit clauses, and these extra units),
+// then what's left split into its connected components: two clauses are
+// in the same one if they share a variable. Literals fixed by the
+// propagation go in fixed, in the input's names. False if that's a
+// conflict.
+bool decompose(const cnf& c, const std::vector<int>& names, const std::vector<literal>& units,
+               std::vector<component>& parts, std::vector<literal>& fixed) {
+    const int n = c.max_literal_count / 2;
+    auto input = [&](literal l) {
+        literal p = literal::positive(names[l.var()]);
+        return l.is_negative() ? -p : p;
+    };
+
+    // The clauses containing literal l are occ[occ_start[l] .. occ_start[l+1]].
+    std::vector<int> occ_start(c.max_literal_count + 3, 0);
+    for (auto cit = c.clause_begin(); cit != c.clause_end(); ++cit) {
+        for (literal l : cit) { occ_start[l.index() + 1]++; }
+    }
+    for (size_t i = 1; i < occ_start.size(); ++i) { occ_start[i] += occ_start[i - 1]; }
+    std::vector<int> occ(occ_start.back());
+    std::vector<int> fill(occ_start.begin(), occ_start.end() - 1);
+    for (int ci = 0; ci < c.clauses_count; ++ci) {
+        for (literal l : c.clause_begin() + ci) { occ[fill[l.index()]++] = ci; }
+    }
+
+    // Per variable: 1 or -1 once fixed.
+    std::vector<signed char> value(n + 1, 0);
+    auto is_true = [&](literal l) { return value[l.var()] == (l.is_negative() ? -1 : 1); };
+    auto is_false = [&](literal l) { return value[l.var()] == (l.is_negative() ? 1 : -1); };
+    std::vector<literal> trail;
+    auto assign = [&](literal l) {
+        if (is_true(l)) { return true; }
+        if (is_false(l)) { return false; }
+        value[l.var()] = l.is_negative() ? -1 : 1;
+        trail.push_back(l);
+        return true;
+    };
+    for (literal l : units) {
+        if (!assign(l)) { return false; }
+    }
+    for (auto cit = c.clause_begin(); cit != c.clause_end(); ++cit) {
+        if (size(cit) == 0) { return false; }
+        if (size(cit) == 1 && !assign(*cit->start)) { return false; }
+    }
+    for (size_t head = 0; head < trail.size(); ++head) {
+        const literal f = -trail[head];
+        for (int i = occ_start[f.index()]; i < occ_start[f.index() + 1]; ++i) {
+            literal open;
+            int open_count = 0;
+            bool satisfied = false;
+            for (literal l : c.clause_begin() + occ[i]) {
+                if (is_true(l)) { satisfied = true; break; }
+                if (!is_false(l)) {
+                    open = l;
+                    open_count++;
+                }
+            }
+            if (satisfied) { continue; }
+            if (open_count == 0) { return false; }
+            if (open_count == 1) { assign(open); }
+        }
+    }
+    for (literal l : trail) { fixed.push_back(input(l)); }
+
+    // What's left of each clause, and its component.
+    std::vector<literal> lits;
+    std::vector<int> starts;
+    disjoint_sets sets(n);
+    for (auto cit = c.clause_begin(); cit != c.clause_end(); ++cit) {
+        if (std::any_of(cit->start, cit->finish, is_true)) { continue; }
+        starts.push_back(lits.size());
+        for (literal l : cit) {
+            if (is_false(l)) { continue; }
+            lits.push_back(l);
+            sets.unite(lits[starts.back()].var(), l.var());
+        }
+    }
+    starts.push_back(lits.size());
+
+    // Number the components, and their variables, in order of variable.
+    std::vector<int> which(n + 1, -1), local(n + 1, 0);
+    std::vector<int> vars_in, clauses_in, lits_in;
+    std::vector<bool> used(n + 1, false);
+    for (literal l : lits) { used[l.var()] = true; }
+    for (int v = 1; v <= n; ++v) {
+        if (!used[v]) { continue; }
+        const int root = sets.find(v);
+        if (which[root] < 0) {
+            which[root] = vars_in.size();
+            vars_in.push_back(0);
+            clauses_in.push_back(0);
+            lits_in.push_back(0);
+        }
+        local[v] = ++vars_in[which[root]];
+    }
+    for (size_t i = 0; i + 1 < starts.size(); ++i) {
+        const int k = which[sets.find(lits[starts[i]].var())];
+        clauses_in[k]++;
+        lits_in[k] += starts[i + 1] - starts[i];
+    }
+
+    const size_t first = parts.size();
+    for (size_t k = 0; k < vars_in.size(); ++k) {
+        parts.push_back({cnf(std::max(lits_in[k], 1), std::max(clauses_in[k], 1), 2 * vars_in[k]),
+                         std::vector<int>(vars_in[k] + 1, 0)});
+    }
+    for (int v = 1; v <= n; ++v) {
+        if (used[v]) { parts[first + which[sets.find(v)]].names[local[v]] = names[v]; }
+    }
+    std::vector<literal> clause;
+    for (size_t i = 0; i + 1 < starts.size(); ++i) {
+        auto& part = parts[first + which[sets.find(lits[starts[i]].var())]];
+        clause.clear();
+        for (int j = starts[i]; j < starts[i + 1]; ++j) {
+            literal p = literal::positive(local[lits[j].var()]);
+            clause.push_back(lits[j].is_negative() ? -p : p);
+        }
+        part.formula.insert_clause(clause);
+    }
+    return true;
+}
+
+// Solves c a component at a time, each as its own instance with config,
+// on up to threads threads, biggest first. The first unsat component
+// stops the others. With redecompose, a component that's fixed enough
+// literals at the root (a twentieth of its variables, or 16) is stopped,
+// simplified with them, and split again; if that doesn't split it, it's
+// solved through. The model is in c's names.
+bool solve_components(const configuration& config, cnf& c, statistics& stats,
+                      std::vector<literal>& model, int threads, bool redecompose) {
+    std::vector<int> names(c.max_literal_count / 2 + 1);
+    std::iota(names.begin(), names.end(), 0);
+    struct task {
+        component part;
+        bool may_redecompose;
+    };
+    std::vector<component> parts;
+    std::vector<task> tasks;
+    if (!decompose(c, names, {}, parts, model)) { return false; }
+    for (auto& part : parts) { tasks.push_back({std::move(part), redecompose}); }
+    STAT(stats.components = tasks.size());
+
+    // A heap by size, so we take the biggest first.
+    auto by_size = [](const task& x, const task& y) {
+        return x.part.formula.raw_data_count < y.part.formula.raw_data_count;
+    };
+    std::make_heap(tasks.begin(), tasks.end(), by_size);
+
+    std::mutex m;
+    std::condition_variable changed;
+    int running = 0;
+    std::atomic<bool> unsat{false};
+    const memory_policy policy = current_memory_policy;
+
+    auto work = [&]() {
+        current_memory_policy = policy;
+        std::unique_lock<std::mutex> lock(m);
+        for (;;) {
+            changed.wait(lock, [&]() { return unsat || !tasks.empty() || running == 0; });
+            if (unsat || tasks.empty()) { break; }
+            std::pop_heap(tasks.begin(), tasks.end(), by_size);
+            task t = std::move(tasks.back());
+            tasks.pop_back();
+            running++;
+            lock.unlock();
+
+            statistics local;
+            std::vector<literal> local_model;
+            search_control control;
+            control.stop = &unsat;
+            const int vars = t.part.formula.max_literal_count / 2;
+            if (t.may_redecompose) { control.root_units = std::max(16, vars / 20); }
+            const bool result = config.solve(t.part.formula, local, local_model, &control);
+
+            std::vector<component> pieces;
+            std::vector<literal> fixed;
+            bool split_ok = true;
+            if (control.interrupted && !unsat) {
+                split_ok = decompose(t.part.formula, t.part.names, control.units, pieces, fixed);
+            }
+
+            lock.lock();
+            stats.add(local);
+            if (!control.interrupted) {
+                if (result) {
+                    for (literal l : local_model) { model.push_back(t.part.to_input(l)); }
+                }
+                else {
+                    unsat = true;
+                }
+            }
+            else if (!unsat) {
+                STAT(stats.redecompositions++);
+                if (!split_ok) { unsat = true; }
+                model.insert(model.end(), fixed.begin(), fixed.end());
+                STAT(stats.components += pieces.size() - 1);
+                for (auto& piece : pieces) {
+                    tasks.push_back({std::move(piece), pieces.size() > 1});
+                    std::push_heap(tasks.begin(), tasks.end(), by_size);
+                }
+            }
+            running--;
+            changed.notify_all();
+        }
+        changed.notify_all();
+    };
+
+    std::vector<std::thread> pool;
+    PROFSTMT(profiler& main_profile = profiler::instance());
+    for (int i = 1; i < threads; ++i) {
+        pool.emplace_back([&]() {
+            work();
+            PROFSTMT(std::lock_guard<std::mutex> lock(m); main_profile.merge(profiler::instance()));
+        });
+    }
+    work();
+    for (auto& t : pool) { t.join(); }
+    return !unsat;
+}
+
+#endif
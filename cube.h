@@ -0,0 +1,263 @@
+#ifndef CUBE_H
+#define CUBE_H
+
+#include "literal_map.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <iostream>
+#include <iterator>
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// A whole input file as one read-only range of chars: mmapped if we can,
+// otherwise (pipes, stdin) read into memory.
+class input_buffer {
+    const char* start = nullptr;
+    size_t length = 0;
+    void* mapping = MAP_FAILED;
+    std::vector<char> copy;
+
+    void read_all(int fd) {
+        char chunk[1 << 16];
+        ssize_t n;
+        while ((n = read(fd, chunk, sizeof(chunk))) > 0) {
+            copy.insert(copy.end(), chunk, chunk + n);
+        }
+        start = copy.data();
+        length = copy.size();
+    }
+
+public:
+    bool ok = true;
+
+    // "-" means stdin.
+    explicit input_buffer(const char* path) {
+        if (!strcmp(path, "-")) {
+            read_all(0);
+            return;
+        }
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            ok = false;
+            return;
+        }
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        if (mapping != MAP_FAILED) {
+            madvise(mapping, st.st_size, MADV_SEQUENTIAL);
+            start = static_cast<const char*>(mapping);
+            length = st.st_size;
+        }
+        else {
+            read_all(fd);
+        }
+        close(fd);
+    }
+    ~input_buffer() {
+        if (mapping != MAP_FAILED) { munmap(mapping, length); }
+    }
+    input_buffer(const input_buffer&) = delete;
+    input_buffer& operator=(const input_buffer&) = delete;
+
+    const char* begin() const { return start; }
+    const char* end() const { return start + length; }
+};
+
+// Applies a partial assignment (a cube) to a formula in one pass over its
+// text: clauses the cube satisfies are dropped, literals it falsifies are
+// stripped, and the variables left are renumbered 1..n, keeping their
+// order. The result is kept as DIMACS numbers, ready for a sink (see
+// generators.h): dimacs_sink to write it out, cnf_sink to solve it.
+//
+// This is what helpers/SelfReduce.py used to do, and gives the same
+// clauses.
+class cube_reduction {
+    // Per input variable: 1 or -1 if the cube fixes it, 0 if not.
+    std::vector<signed char> fixed;
+
+    void fix(int x) {
+        size_t v = std::abs(x);
+        if (v >= fixed.size()) { fixed.resize(v + 1, 0); }
+        fixed[v] = x > 0 ? 1 : -1;
+    }
+    signed char value(int x) const {
+        size_t v = std::abs(x);
+        if (v >= fixed.size() || !fixed[v]) { return 0; }
+        return x > 0 ? fixed[v] : -fixed[v];
+    }
+
+    // The variable count on the "p cnf" line, or 0 if there isn't one.
+    static int header_variables(const input_buffer& in) {
+        const char* p = in.begin();
+        const char* end = in.end();
+        while (p < end) {
+            if (*p == 'p') {
+                while (p < end && !(*p >= '0' && *p <= '9') && *p != '\n') { ++p; }
+                int n = 0;
+                while (p < end && *p >= '0' && *p <= '9') { n = n * 10 + (*p++ - '0'); }
+                return n;
+            }
+            if (*p != 'c' && *p != '\n') { return 0; }
+            while (p < end && *p != '\n') { ++p; }
+            ++p;
+        }
+        return 0;
+    }
+
+    // Calls f on each number in the text, skipping comment and header
+    // lines; stops at a '%' line (as SATLIB files end with one).
+    template<typename F>
+    static void for_each_number(const input_buffer& in, F f) {
+        const char* p = in.begin();
+        const char* end = in.end();
+        bool line_start = true;
+        while (p < end) {
+            char ch = *p;
+            if (line_start && (ch == 'c' || ch == 'p' || ch == 'v' || ch == 's')) {
+                // comments, the header, and (for models) the v/s prefixes.
+                if (ch == 'v') { ++p; line_start = false; continue; }
+                while (p < end && *p != '\n') { ++p; }
+                continue;
+            }
+            if (line_start && ch == '%') { return; }
+            if (ch == '-' || (ch >= '0' && ch <= '9')) {
+                bool negative = (ch == '-');
+                if (negative) { ++p; }
+                long x = 0;
+                while (p < end && *p >= '0' && *p <= '9') { x = x * 10 + (*p++ - '0'); }
+                f(negative ? -x : x);
+                line_start = false;
+                continue;
+            }
+            line_start = (ch == '\n');
+            ++p;
+        }
+    }
+
+public:
+    // new_var[v] is what input variable v is called in the reduced formula
+    // (0 if it's gone); old_var is the inverse, index 0 unused.
+    std::vector<int> new_var;
+    std::vector<int> old_var{0};
+    // The reduced clauses, each terminated by a 0.
+    std::vector<int> lits;
+    long clause_count = 0;
+    long satisfied_clauses = 0;
+    long stripped_literals = 0;
+    bool has_empty_clause = false;
+    // The highest variable the input declares or uses, satisfied clauses
+    // included.
+    int input_variables = 0;
+
+    // The cube is whitespace-separated DIMACS literals; 0s, and "v"/"s"
+    // line prefixes as in a solver's model output, are ignored.
+    void read_cube(const input_buffer& in) {
+        for_each_number(in, [&](long x) {
+            if (x != 0) { fix(x); }
+        });
+    }
+
+    void reduce(const input_buffer& in) {
+        input_variables = header_variables(in);
+        // The current clause's unfixed literals; we only keep them once we
+        // know the clause survives. They're renamed at the end.
+        std::vector<int> pending;
+        bool sat = false;
+        auto finish_clause = [&]() {
+            if (sat) {
+                satisfied_clauses++;
+            }
+            else {
+                if (pending.empty()) { has_empty_clause = true; }
+                const size_t clause_start = lits.size();
+                for (int x : pending) {
+                    size_t v = std::abs(x);
+                    if (v >= new_var.size()) { new_var.resize(v + 1, 0); }
+                    new_var[v] = 1;
+                    // the input may repeat a literal; the solver wants sets.
+                    if (std::find(lits.begin() + clause_start, lits.end(), x) == lits.end()) {
+                        lits.push_back(x);
+                    }
+                }
+                lits.push_back(0);
+                clause_count++;
+            }
+            pending.clear();
+            sat = false;
+        };
+        for_each_number(in, [&](long x) {
+            if (x == 0) {
+                finish_clause();
+                return;
+            }
+            input_variables = std::max(input_variables, int(std::abs(x)));
+            if (sat) { return; }
+            signed char val = value(x);
+            if (val > 0) { sat = true; }
+            else if (val < 0) { stripped_literals++; }
+            else { pending.push_back(x); }
+        });
+        // A last clause missing its 0.
+        if (sat || !pending.empty()) { finish_clause(); }
+
+        for (size_t v = 1; v < new_var.size(); ++v) {
+            if (!new_var[v]) { continue; }
+            new_var[v] = old_var.size();
+            old_var.push_back(v);
+        }
+        for (int& x : lits) {
+            if (x) { x = x > 0 ? new_var[x] : -new_var[-x]; }
+        }
+    }
+
+    int variable_count() const { return old_var.size() - 1; }
+    // The highest variable the input or the cube mentioned.
+    int input_variable_count() const {
+        return std::max(input_variables, int(fixed.size()) - 1);
+    }
+
+    template<typename Sink>
+    void write(Sink& out) const {
+        out.header(variable_count(), clause_count);
+        std::vector<int> c;
+        for (int x : lits) {
+            if (x) {
+                c.push_back(x);
+                continue;
+            }
+            out.clause(c);
+            c.clear();
+        }
+    }
+
+    // "new old" per line, for lifting models of the reduced formula.
+    void write_map(FILE* out) const {
+        for (int v = 1; v <= variable_count(); ++v) {
+            fprintf(out, "%d %d\n", v, old_var[v]);
+        }
+    }
+
+    // A model of the reduced formula as one of the input: the cube, plus
+    // the model's literals under their input names.
+    std::vector<literal> lift(const std::vector<literal>& model) const {
+        std::vector<literal> result;
+        for (size_t v = 1; v < fixed.size(); ++v) {
+            if (fixed[v]) { result.push_back(literal::from_dimacs(fixed[v] * int(v))); }
+        }
+        for (literal l : model) {
+            literal original = literal::positive(old_var[l.var()]);
+            result.push_back(l.is_negative() ? -original : original);
+        }
+        return result;
+    }
+};
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef DECISION_HEAP_H
+#define DECISION_HEAP_H
+
+#include <vector>
+
+// A binary max-heap of variables, ordered by a score array it doesn't own,
+// with each variable's position so a changed score can be fixed up in
+// O(log n). This is what a score-based heuristic decides from: the top,
+// once the assigned variables on it have been popped off. (Variables are
+// put back as they're unassigned.)
+class decision_heap {
+    const std::vector<double>& score;
+    std::vector<int> heap;
+    std::vector<int> position; // -1 if not in the heap
+
+    bool before(int x, int y) const { return score[x] > score[y]; }
+
+    void up(int i) {
+        const int v = heap[i];
+        while (i > 0) {
+            const int parent = (i - 1) / 2;
+            if (!before(v, heap[parent])) { break; }
+            heap[i] = heap[parent];
+            position[heap[i]] = i;
+            i = parent;
+        }
+        heap[i] = v;
+        position[v] = i;
+    }
+    void down(int i) {
+        const int v = heap[i];
+        const int n = heap.size();
+        for (;;) {
+            int child = 2 * i + 1;
+            if (child >= n) { break; }
+            if (child + 1 < n && before(heap[child + 1], heap[child])) { child++; }
+            if (!before(heap[child], v)) { break; }
+            heap[i] = heap[child];
+            position[heap[i]] = i;
+            i = child;
+        }
+        heap[i] = v;
+        position[v] = i;
+    }
+
+public:
+    // Variables 1..variables, scored by score[v].
+    decision_heap(const std::vector<double>& score, int variables):
+        score(score), position(variables + 1, -1) {}
+
+    bool empty() const { return heap.empty(); }
+    bool contains(int v) const { return position[v] >= 0; }
+    int top() const { return heap[0]; }
+
+    void insert(int v) {
+        if (contains(v)) { return; }
+        heap.push_back(v);
+        up(heap.size() - 1);
+    }
+    int pop() {
+        const int v = heap[0];
+        position[v] = -1;
+        const int last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            down(0);
+        }
+        return v;
+    }
+    // score[v] changed (either way).
+    void update(int v) {
+        if (!contains(v)) { return; }
+        up(position[v]);
+        down(position[v]);
+    }
+};
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef DIMACS_H
+#define DIMACS_H
+
+#include "cnf.h"
+#include "stamped_set.h"
+
+#include <iostream>
+#include <sstream>
+#include <iterator>
+#include <vector>
+#include <string>
+#include <cstdlib>
+
+namespace cnf_reader {
+    typedef int variable;
+    typedef int literal;
+
+    typedef std::vector<literal> basic_clause;
+    typedef std::vector<basic_clause> basic_cnf;
+
+    basic_cnf cnf_from_stream(std::istream& in) {
+        // very simple parsing, assuming things are pretty well-formatted.
+        // Repeated literals are dropped; seen is by literal index (2|x|,
+        // plus 1 if negative), and grows with the variables.
+        basic_cnf result;
+        stamped_set seen;
+        std::string line;
+        while (getline(in, line)) {
+            if (line.size() < 1 ||
+                    line[0] == 'c' ||
+                    line[0] == 'p') {
+                continue;
+            }
+            if (line[0] == '%') { break; }
+            basic_clause new_clause;
+            seen.clear();
+            auto to_parse = std::istringstream(line);
+            std::istream_iterator<literal> literal_reader{to_parse};
+            std::istream_iterator<literal> end_of_line;
+            while (literal_reader != end_of_line) {
+                literal l = *literal_reader++;
+                if (l == 0) { break; }
+                const size_t index = 2 * size_t(std::abs(l)) + (l < 0);
+                seen.resize(index + 1);
+                if (seen.insert(index)) { new_clause.push_back(l); }
+            }
+            result.push_back(new_clause);
+        }
+        return result;
+    }
+
+    basic_cnf cnf_from_stdin() { return cnf_from_stream(std::cin); }
+}
+
+// Build the solver's table from the simple parsed form.
+cnf load_cnf(const cnf_reader::basic_cnf& simple_table) {
+    int size = 0;
+    int literal_count = 0;
+    int clause_count = 0;
+    for (auto cl : simple_table) {
+        size += cl.size();
+        clause_count++;
+        for (auto x : cl) {
+            auto y = std::abs(x);
+            literal_count = std::max(literal_count, y);
+        }
+    }
+    literal_count *= 2;
+
+    cnf result(size, clause_count, literal_count);
+
+    // This is where DIMACS numbers become our literals.
+    std::vector<literal> lits;
+    for (const auto& cl : simple_table) {
+        lits.clear();
+        for (auto x : cl) { lits.push_back(literal::from_dimacs(x)); }
+        result.insert_clause(lits);
+    }
+    return result;
+}
+
+cnf load_cnf() {
+    return load_cnf(cnf_reader::cnf_from_stdin());
+}
+
+#endif
@@ -0,0 +1,25 @@
+# Compare how long we take to solve against how long drat-check takes to
+# verify the proof, for every unsat instance in inputs/$1*.
+# e.g.: ./drat_bench.sh uuf100
+proof=$(mktemp)
+total_solve=0
+total_check=0
+printf "%-30s %10s %10s %8s\n" instance solve_ms check_ms ratio
+for f in inputs/$1*
+do
+    start=$(date +%s%N)
+    result=$(./sat --proof=$proof < $f)
+    solved=$(date +%s%N)
+    if [ "$result" != "0" ]; then continue; fi
+    ./drat-check $f $proof > /dev/null || echo "$f: proof NOT VERIFIED"
+    checked=$(date +%s%N)
+    solve_ms=$(( (solved - start) / 1000000 ))
+    check_ms=$(( (checked - solved) / 1000000 ))
+    total_solve=$(( total_solve + solve_ms ))
+    total_check=$(( total_check + check_ms ))
+    printf "%-30s %10d %10d %8s\n" $(basename $f) $solve_ms $check_ms \
+        $(awk "BEGIN { printf \"%.2f\", $check_ms / ($solve_ms + 1) }")
+done
+printf "%-30s %10d %10d %8s\n" total $total_solve $total_check \
+    $(awk "BEGIN { printf \"%.2f\", $total_check / ($total_solve + 1) }")
+rm -f $proof
@@ -0,0 +1,77 @@
+#include "drat_checker.h"
+
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    const char* cnf_file = nullptr;
+    const char* proof_file = nullptr;
+    const char* lrat_file = nullptr;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 1; i < argc; ++i) {
+        if (!strncmp(argv[i], "--threads=", 10)) { threads = std::max(1, atoi(argv[i] + 10)); }
+        else if (!strncmp(argv[i], "--lrat=", 7)) { lrat_file = argv[i] + 7; }
+        else if (!cnf_file) { cnf_file = argv[i]; }
+        else if (!proof_file) { proof_file = argv[i]; }
+        else { proof_file = nullptr; break; }
+    }
+    if (!cnf_file || !proof_file) {
+        cerr << "usage: " << argv[0] << " input.cnf proof.drat [--threads=N] [--lrat=FILE]" << endl;
+        return 1;
+    }
+
+    auto start = chrono::steady_clock::now();
+
+    ifstream cnf_in(cnf_file);
+    if (!cnf_in) {
+        cerr << "cannot open " << cnf_file << endl;
+        return 1;
+    }
+    auto formula = cnf_reader::cnf_from_stream(cnf_in);
+
+    FILE* proof_in = fopen(proof_file, "rb");
+    if (!proof_in) {
+        cerr << "cannot open " << proof_file << endl;
+        return 1;
+    }
+    auto proof = proof_reader::read(proof_in);
+    fclose(proof_in);
+
+    drat_checker checker(formula, proof);
+    auto parsed = chrono::steady_clock::now();
+
+    bool ok = checker.check(threads);
+    auto checked = chrono::steady_clock::now();
+
+    auto seconds = [](chrono::steady_clock::duration d) {
+        return chrono::duration<double>(d).count();
+    };
+    cout << "c parsed " << checker.original_count << " clauses and "
+         << checker.lemma_count() << " lemmas in " << seconds(parsed - start) << "s" << endl;
+    cout << "c verified " << checker.verified_count() << " lemmas with "
+         << threads << " threads in " << checker.rounds << " rounds, "
+         << seconds(checked - parsed) << "s" << endl;
+
+    if (!ok) {
+        cout << "c failed lemma: " << checker.clause(checker.failed_clause) << endl;
+        cout << "s NOT VERIFIED" << endl;
+        return 1;
+    }
+
+    if (lrat_file) {
+        FILE* out = fopen(lrat_file, "w");
+        if (!out) {
+            cerr << "cannot open " << lrat_file << endl;
+            return 1;
+        }
+        checker.write_lrat(out);
+        fclose(out);
+    }
+    cout << "s VERIFIED" << endl;
+    return 0;
+}
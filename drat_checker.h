@@ -0,0 +1,546 @@
+#ifndef DRAT_CHECKER_H
+#define DRAT_CHECKER_H
+
+#include "debug.h"
+#include "cnf.h"
+#include "literal_map.h"
+#include "dimacs.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <unordered_map>
+#include <climits>
+#include <cstdio>
+#include <cstdint>
+
+// Reads a DRAT proof, in either the binary or textual format.
+namespace proof_reader {
+    struct raw_step {
+        bool deletion;
+        std::vector<literal> lits;
+    };
+
+    // Binary proofs start with an 'a' or 'd' byte followed by (usually
+    // unprintable) numbers; text proofs are digits, '-', "d " and whitespace.
+    bool looks_binary(const std::vector<unsigned char>& data) {
+        if (data.empty()) { return false; }
+        if (data[0] == 'a') { return true; }
+        if (data[0] == 'd' && data.size() > 1 && data[1] == ' ') { return false; }
+        for (size_t i = 0; i < data.size() && i < 16; ++i) {
+            unsigned char c = data[i];
+            if (c != '\n' && c != '\r' && c != '\t' && (c < 32 || c > 126)) {
+                return true;
+            }
+        }
+        return data[0] == 'd';
+    }
+
+    std::vector<raw_step> read_binary(const std::vector<unsigned char>& data) {
+        std::vector<raw_step> result;
+        size_t i = 0;
+        while (i < data.size()) {
+            raw_step s;
+            s.deletion = (data[i++] == 'd');
+            for (;;) {
+                unsigned long x = 0;
+                int shift = 0;
+                while (i < data.size()) {
+                    unsigned char b = data[i++];
+                    x |= static_cast<unsigned long>(b & 127) << shift;
+                    shift += 7;
+                    if (b < 128) { break; }
+                }
+                if (x == 0) { break; }
+                // binary DRAT's 2|x| + (x < 0) is exactly our encoding.
+                s.lits.push_back(literal(static_cast<unsigned>(x)));
+            }
+            result.push_back(std::move(s));
+        }
+        return result;
+    }
+
+    std::vector<raw_step> read_text(const std::vector<unsigned char>& data) {
+        std::vector<raw_step> result;
+        raw_step s{false, {}};
+        size_t i = 0;
+        while (i < data.size()) {
+            unsigned char c = data[i];
+            if (c == 'c') {
+                while (i < data.size() && data[i] != '\n') { ++i; }
+                continue;
+            }
+            if (c == 'd') { s.deletion = true; ++i; continue; }
+            if (c == '-' || (c >= '0' && c <= '9')) {
+                bool negative = (c == '-');
+                if (negative) { ++i; }
+                long x = 0;
+                while (i < data.size() && data[i] >= '0' && data[i] <= '9') {
+                    x = x * 10 + (data[i++] - '0');
+                }
+                if (x == 0) {
+                    result.push_back(std::move(s));
+                    s = raw_step{false, {}};
+                }
+                else {
+                    s.lits.push_back(literal::from_dimacs(negative ? -x : x));
+                }
+                continue;
+            }
+            ++i;
+        }
+        return result;
+    }
+
+    std::vector<raw_step> read(FILE* f) {
+        std::vector<unsigned char> data;
+        unsigned char buffer[1 << 16];
+        size_t n;
+        while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+            data.insert(data.end(), buffer, buffer + n);
+        }
+        return looks_binary(data) ? read_binary(data) : read_text(data);
+    }
+}
+
+// Backward DRAT checking, in the style of drat-trim:
+//  - the formula and every lemma live in one cnf, indexed by clause number;
+//  - a clause is "active" for the lemma at step s if it was added before s
+//    and not deleted before s;
+//  - starting from the empty clause, we only verify lemmas that some
+//    already-verified lemma actually used (they're "marked");
+//  - propagation is core-first: marked clauses are tried before the rest,
+//    so we keep reusing the same small core.
+//
+// Each worker thread has its own assignment and watches, so independent
+// lemmas are verified concurrently. Marks are the only shared mutable state.
+class drat_checker {
+public:
+    enum clause_state : char { unmarked, marked, verifying, verified };
+
+    struct proof_step {
+        int index;
+        bool deletion;
+    };
+
+    cnf db;
+    int original_count = 0;
+    std::vector<proof_step> steps;
+    int empty_step = -1;
+
+    std::unique_ptr<int[]> added_at;
+    std::unique_ptr<int[]> deleted_at;
+    std::unique_ptr<std::atomic<char>[]> state;
+    // The antecedents we found for each verified lemma. A negative entry
+    // -(d+1) starts the RAT block for candidate clause d.
+    std::vector<std::vector<long>> hints;
+    std::vector<int> units;
+
+    std::atomic<bool> failed{false};
+    int failed_clause = -1;
+    int rounds = 0;
+
+private:
+    static std::vector<literal> sorted_copy(cnf::clause_iterator cit) {
+        std::vector<literal> v(begin(cit), end(cit));
+        std::sort(v.begin(), v.end());
+        return v;
+    }
+    static uint64_t clause_hash(const std::vector<literal>& v) {
+        uint64_t h = 14695981039346656037ull;
+        for (literal l : v) {
+            h ^= l.index();
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    static cnf make_db(const cnf_reader::basic_cnf& formula,
+                       const std::vector<proof_reader::raw_step>& proof) {
+        int size = 0, clauses = 1, max_var = 1;
+        for (const auto& cl : formula) {
+            size += cl.size();
+            clauses++;
+            for (int x : cl) { max_var = std::max(max_var, std::abs(x)); }
+        }
+        for (const auto& s : proof) {
+            if (s.deletion) { continue; }
+            size += s.lits.size();
+            clauses++;
+            for (literal l : s.lits) { max_var = std::max(max_var, l.var()); }
+        }
+        return cnf(std::max(size, 1), clauses, 2 * max_var);
+    }
+
+public:
+    bool active(int ci, int step) const {
+        return added_at[ci] < step && deleted_at[ci] > step;
+    }
+    bool is_lemma(int ci) const { return ci >= original_count; }
+    cnf::clause_iterator clause(int ci) const { return db.clause_begin() + ci; }
+
+    void mark(int ci) {
+        char expected = unmarked;
+        state[ci].compare_exchange_strong(expected, marked);
+    }
+
+    drat_checker(const cnf_reader::basic_cnf& formula,
+                 const std::vector<proof_reader::raw_step>& proof):
+        db(make_db(formula, proof))
+    {
+        const int capacity = db.clauses_max;
+        added_at = std::make_unique<int[]>(capacity);
+        deleted_at = std::make_unique<int[]>(capacity);
+        state = std::make_unique<std::atomic<char>[]>(capacity);
+        hints.resize(capacity);
+
+        std::unordered_map<uint64_t, std::vector<int>> live;
+        auto add = [&](cnf::clause_iterator cit, int step) {
+            int ci = cit - db.clause_begin();
+            added_at[ci] = step;
+            deleted_at[ci] = INT_MAX;
+            state[ci] = unmarked;
+            if (size(cit) == 1) { units.push_back(ci); }
+            live[clause_hash(sorted_copy(cit))].push_back(ci);
+            return ci;
+        };
+
+        std::vector<literal> lits;
+        for (const auto& cl : formula) {
+            lits.clear();
+            for (int x : cl) { lits.push_back(literal::from_dimacs(x)); }
+            add(db.insert_clause(lits), -1);
+        }
+        original_count = db.clauses_count;
+
+        for (const auto& s : proof) {
+            const int step = steps.size();
+            if (!s.deletion) {
+                int ci = add(db.insert_clause(s.lits), step);
+                steps.push_back({ci, false});
+                if (s.lits.empty()) {
+                    empty_step = step;
+                    break; // nothing after the empty clause matters.
+                }
+                continue;
+            }
+            // Like drat-trim, we ignore unit deletions: solvers routinely
+            // delete reason clauses they've already propagated at the top.
+            if (s.lits.size() == 1) { continue; }
+            std::vector<literal> key(s.lits);
+            std::sort(key.begin(), key.end());
+            auto& candidates = live[clause_hash(key)];
+            auto it = std::find_if(candidates.begin(), candidates.end(), [&](int ci) {
+                return sorted_copy(clause(ci)) == key;
+            });
+            if (it == candidates.end()) {
+                TRACE("ignoring deletion of missing clause\n");
+                continue;
+            }
+            deleted_at[*it] = step;
+            steps.push_back({*it, true});
+            candidates.erase(it);
+        }
+
+        // No empty clause: the proof still holds if everything it derived
+        // propagates to a conflict, so check that as a final virtual lemma.
+        if (empty_step == -1) {
+            std::vector<literal> empty;
+            empty_step = steps.size();
+            steps.push_back({add(db.insert_clause(empty), empty_step), false});
+        }
+    }
+
+    // Everything a single thread needs to check lemmas on its own.
+    class verifier {
+        struct watch_struct {
+            literal w1, w2;
+        };
+        drat_checker& d;
+        literal_map<signed char> value;
+        literal_map<int> reason;
+        literal_map<char> seen;
+        literal_map<std::vector<int>> watch_lists;
+        std::unique_ptr<watch_struct[]> watches_by_clause;
+        std::vector<literal> trail;
+
+        bool is_true(literal l) const { return value.get_copy(l) == 1; }
+        bool is_false(literal l) const { return value.get_copy(l) == -1; }
+
+        void assign(literal l, int why) {
+            value[l] = 1;
+            value[-l] = -1;
+            reason[l] = why;
+            trail.push_back(l);
+        }
+
+        void reset() {
+            for (literal l : trail) {
+                value[l] = 0;
+                value[-l] = 0;
+            }
+            trail.clear();
+        }
+
+        literal find_new_literal(cnf::clause_iterator cit, const watch_struct& p) const {
+            for (literal x : cit) {
+                if (x == p.w1 || x == p.w2) { continue; }
+                if (!is_false(x)) { return x; }
+            }
+            return literal();
+        }
+
+        // Returns the index of a falsified clause, or -1.
+        int propagate_literal(literal l, int step, bool core_only) {
+            auto& to_visit = watch_lists[-l];
+            for (size_t i = 0; i < to_visit.size(); ) {
+                int ci = to_visit[i];
+                if ((core_only && d.state[ci].load(std::memory_order_relaxed) == unmarked) ||
+                    !d.active(ci, step)) {
+                    ++i;
+                    continue;
+                }
+                watch_struct& p = watches_by_clause[ci];
+                if (p.w2 == -l) { std::swap(p.w1, p.w2); }
+                ASSERT(p.w1 == -l);
+                if (is_true(p.w2)) { ++i; continue; }
+
+                literal wn = find_new_literal(d.clause(ci), p);
+                if (wn) {
+                    p.w1 = wn;
+                    watch_lists[wn].push_back(ci);
+                    to_visit[i] = to_visit.back();
+                    to_visit.pop_back();
+                    continue;
+                }
+                if (is_false(p.w2)) { return ci; }
+                assign(p.w2, ci);
+                ++i;
+            }
+            return -1;
+        }
+
+        // Core-first: exhaust the marked clauses before looking at the rest,
+        // and go back to them as soon as anything new is assigned.
+        int propagate(int step) {
+            size_t core_head = 0, all_head = 0;
+            for (;;) {
+                if (core_head < trail.size()) {
+                    int c = propagate_literal(trail[core_head++], step, true);
+                    if (c != -1) { return c; }
+                }
+                else if (all_head < trail.size()) {
+                    int c = propagate_literal(trail[all_head++], step, false);
+                    if (c != -1) { return c; }
+                }
+                else {
+                    return -1;
+                }
+            }
+        }
+
+        // Mark and record every clause involved in the conflict, in the
+        // order they became unit.
+        void analyze(int conflict, std::vector<long>& out) {
+            size_t first = out.size();
+            for (literal x : d.clause(conflict)) { seen[-x] = 1; }
+            for (auto it = trail.rbegin(); it != trail.rend(); ++it) {
+                literal l = *it;
+                if (!seen[l]) { continue; }
+                int r = reason[l];
+                if (r == -1) { continue; } // one of our assumptions.
+                out.push_back(r);
+                d.mark(r);
+                for (literal x : d.clause(r)) {
+                    if (x != l) { seen[-x] = 1; }
+                }
+            }
+            for (literal l : trail) { seen[l] = 0; }
+            std::reverse(out.begin() + first, out.end());
+            out.push_back(conflict);
+            d.mark(conflict);
+        }
+
+        // Is the (negated) clause refuted by unit propagation at this step?
+        template<typename Iter>
+        bool rup(Iter start, Iter finish, int step, std::vector<long>& out) {
+            reset();
+            for (Iter it = start; it != finish; ++it) {
+                literal l = *it;
+                if (is_false(l)) { continue; }
+                if (is_true(l)) { return true; } // tautology.
+                assign(-l, -1);
+            }
+            for (int u : d.units) {
+                if (!d.active(u, step)) { continue; }
+                literal l = *begin(d.clause(u));
+                if (is_true(l)) { continue; }
+                if (is_false(l)) {
+                    analyze(u, out);
+                    return true;
+                }
+                assign(l, u);
+            }
+            int conflict = propagate(step);
+            if (conflict == -1) { return false; }
+            analyze(conflict, out);
+            return true;
+        }
+
+    public:
+        verifier(drat_checker& d):
+            d(d),
+            value(d.db.max_literal_count),
+            reason(d.db.max_literal_count),
+            seen(d.db.max_literal_count),
+            watch_lists(d.db.max_literal_count),
+            watches_by_clause(std::make_unique<watch_struct[]>(d.db.clauses_max))
+        {
+            for (int ci = 0; ci < d.db.clauses_count; ++ci) {
+                auto cit = d.clause(ci);
+                if (size(cit) < 2) { continue; }
+                watches_by_clause[ci] = {cit->start[0], cit->start[1]};
+                watch_lists[cit->start[0]].push_back(ci);
+                watch_lists[cit->start[1]].push_back(ci);
+            }
+        }
+
+        // RUP first; failing that, RAT on the first literal.
+        bool verify(int ci, int step, std::vector<long>& out) {
+            auto lemma = d.clause(ci);
+            out.clear();
+            if (rup(begin(lemma), end(lemma), step, out)) { return true; }
+            if (size(lemma) == 0) { return false; }
+
+            literal pivot = *begin(lemma);
+            out.clear();
+            std::vector<literal> resolvent;
+            for (int di = 0; di < d.db.clauses_count; ++di) {
+                if (!d.active(di, step)) { continue; }
+                auto other = d.clause(di);
+                if (!clause_contains(other, -pivot)) { continue; }
+                resolvent.assign(begin(lemma), end(lemma));
+                for (literal x : other) {
+                    if (x != -pivot) { resolvent.push_back(x); }
+                }
+                d.mark(di);
+                out.push_back(-(di + 1));
+                if (!rup(resolvent.begin(), resolvent.end(), step, out)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    // Verify lemmas from the empty clause backwards. Threads pull proof
+    // positions off a shared cursor; a lemma that gets marked after every
+    // thread has gone past it is picked up by another round.
+    bool check(int thread_count) {
+        mark(steps[empty_step].index);
+        std::vector<std::unique_ptr<verifier>> verifiers;
+        for (int t = 0; t < thread_count; ++t) {
+            verifiers.push_back(std::make_unique<verifier>(*this));
+        }
+
+        std::atomic<int> cursor;
+        auto work = [&](verifier& v) {
+            for (;;) {
+                int s = cursor.fetch_sub(1);
+                if (s < 0 || failed) { return; }
+                if (steps[s].deletion) { continue; }
+                int ci = steps[s].index;
+                char expected = marked;
+                if (!state[ci].compare_exchange_strong(expected, verifying)) { continue; }
+                if (!v.verify(ci, s, hints[ci])) {
+                    // Two threads can fail at once; the first one says which.
+                    bool was = false;
+                    if (failed.compare_exchange_strong(was, true)) { failed_clause = ci; }
+                    return;
+                }
+                state[ci] = verified;
+            }
+        };
+
+        do {
+            rounds++;
+            cursor = empty_step;
+            std::vector<std::thread> threads;
+            for (int t = 1; t < thread_count; ++t) {
+                threads.emplace_back(work, std::ref(*verifiers[t]));
+            }
+            work(*verifiers[0]);
+            for (auto& t : threads) { t.join(); }
+        } while (!failed && std::any_of(steps.begin(), steps.begin() + empty_step + 1,
+                                        [&](const proof_step& s) {
+            return !s.deletion && state[s.index] == marked;
+        }));
+        return !failed;
+    }
+
+    int lemma_count() const {
+        return std::count_if(steps.begin(), steps.end(), [](const proof_step& s) {
+            return !s.deletion;
+        });
+    }
+    int verified_count() const {
+        return std::count_if(steps.begin(), steps.end(), [&](const proof_step& s) {
+            return !s.deletion && state[s.index] == verified;
+        });
+    }
+
+    // A trimmed, textual LRAT proof: only the lemmas we verified, each
+    // with its hints, and every clause deleted right after its last use.
+    void write_lrat(FILE* out) const {
+        std::vector<int> core;
+        for (int s = 0; s <= empty_step; ++s) {
+            if (!steps[s].deletion && state[steps[s].index] == verified) {
+                core.push_back(steps[s].index);
+            }
+        }
+
+        std::vector<long> id(db.clauses_count, 0);
+        for (int ci = 0; ci < original_count; ++ci) { id[ci] = ci + 1; }
+        long next_id = original_count + 1;
+        for (int ci : core) { id[ci] = next_id++; }
+
+        auto index_of = [](long h) { return h < 0 ? -h - 1 : h; };
+        // last_use[ci] == k means clause ci is last needed by core[k];
+        // -1 means only the original formula ever referred to it.
+        std::vector<int> last_use(db.clauses_count, -1);
+        for (size_t k = 0; k < core.size(); ++k) {
+            for (long h : hints[core[k]]) { last_use[index_of(h)] = k; }
+        }
+        std::vector<std::vector<int>> deletions(core.size());
+        std::vector<int> unused;
+        for (int ci = 0; ci < db.clauses_count; ++ci) {
+            if (!id[ci]) { continue; }
+            if (last_use[ci] == -1) {
+                if (!is_lemma(ci)) { unused.push_back(ci); }
+            }
+            else { deletions[last_use[ci]].push_back(ci); }
+        }
+
+        auto put_deletions = [&](long latest, const std::vector<int>& v) {
+            if (v.empty()) { return; }
+            fprintf(out, "%ld d", latest);
+            for (int ci : v) { fprintf(out, " %ld", id[ci]); }
+            fprintf(out, " 0\n");
+        };
+
+        put_deletions(original_count, unused);
+        for (size_t k = 0; k < core.size(); ++k) {
+            int ci = core[k];
+            fprintf(out, "%ld", id[ci]);
+            for (literal l : clause(ci)) { fprintf(out, " %d", l.to_dimacs()); }
+            fprintf(out, " 0");
+            for (long h : hints[ci]) {
+                fprintf(out, " %ld", h < 0 ? -id[index_of(h)] : id[h]);
+            }
+            fprintf(out, " 0\n");
+            put_deletions(id[ci], deletions[k]);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef EVSIDS_H
+#define EVSIDS_H
+
+#include "literal_map.h"
+#include "assignment.h"
+#include "decision_heap.h"
+#include "stats.h"
+#include "profiler.h"
+#include "checkpoint.h"
+
+#include <vector>
+
+// Exponential VSIDS (as in Chaff, by way of MiniSat): each conflict bumps
+// every variable its analysis touched by inc, and then grows inc by
+// 1/decay, which is the same as decaying all the scores by decay without
+// touching them. Decay is in thousandths, so 950 forgets slowly and 750
+// only really remembers the last few conflicts. We decide on the
+// best-scoring unassigned variable, off the decision heap.
+//
+// Polarity is the saved phase, as for vmtf.
+template<int decay_permille>
+class evsids {
+    const int variables;
+    std::vector<double> score;
+    decision_heap heap;
+    double inc = 1;
+
+    // Which variables we've bumped this conflict.
+    std::vector<unsigned long> seen;
+    unsigned long conflicts = 1;
+
+    variable_map<signed char> phase;
+
+    void bump(int v) {
+        if (seen[v] == conflicts) { return; }
+        seen[v] = conflicts;
+        score[v] += inc;
+        if (score[v] > 1e100) {
+            for (double& s : score) { s *= 1e-100; }
+            inc *= 1e-100;
+        }
+        heap.update(v);
+    }
+
+    public:
+    evsids(const cnf& c, statistics&):
+        variables(c.max_literal_count / 2),
+        score(variables + 1, 0.0),
+        heap(score, variables),
+        seen(variables + 1),
+        phase(c.max_literal_count)
+    {
+        for (int v = 1; v <= variables; ++v) {
+            heap.insert(v);
+            phase[literal::positive(v)] = -1;
+        }
+    }
+
+    literal get_literal(const assignment& a) {
+        PROFILE_SCOPE(phase_decide);
+        while (!heap.empty()) {
+            const literal l = literal::positive(heap.top());
+            if (a.is_unassigned(l)) { return phase[l] < 0 ? -l : l; }
+            heap.pop();
+        }
+        return literal();
+    }
+
+    void set_phase(literal l) { phase[l] = l.is_negative() ? -1 : 1; }
+
+    void assigned(literal) {}
+
+    void analyzed(cnf::clause_iterator reason) {
+        for (literal l : reason) { bump(l.var()); }
+    }
+
+    void learned(const assignment&, cnf::clause_iterator c) {
+        for (literal l : c) { bump(l.var()); }
+        inc *= 1000.0 / decay_permille;
+        conflicts++;
+    }
+
+    void unassigned(const literal* b, const literal* e) {
+        for (; b != e; ++b) {
+            phase[literal::positive(b->var())] = b->is_negative() ? -1 : 1;
+            heap.insert(b->var());
+        }
+    }
+
+    bool should_restart() { return false; }
+
+    // For checkpoint.h: the scores, the increment and the phases.
+    void save(checkpoint_writer& out) const {
+        out.put_double(inc);
+        for (int v = 1; v <= variables; ++v) { out.put_double(score[v]); }
+        for (int v = 1; v <= variables; ++v) { out.put_signed(phase[v]); }
+    }
+    void load(checkpoint_reader& in) {
+        inc = in.get_double();
+        for (int v = 1; v <= variables; ++v) {
+            score[v] = in.get_double();
+            heap.update(v);
+        }
+        for (int v = 1; v <= variables; ++v) { phase[v] = in.get_signed(); }
+    }
+};
+
+#endif
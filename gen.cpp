@@ -0,0 +1,72 @@
+#include "generators.h"
+
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+
+using namespace std;
+
+void usage(const char* name) {
+    cerr << "usage: " << name << " FAMILY [options] > instance.cnf\n"
+         << "  ksat   --vars=N [--k=3] [--ratio=R] [--seed=S]   uniform random k-SAT (R defaults to the threshold)\n"
+         << "  php    --holes=N                                 pigeonhole, N+1 pigeons (unsat)\n"
+         << "  parity --vars=N [--unsat] [--seed=S]             two xor chains over the same variables\n"
+         << "  color  --vertices=N [--degree=D] [--colors=K] [--planted] [--seed=S]\n"
+         << "                                                   graph coloring of a random graph\n"
+         << "                                                   (--planted needs K >= 2)\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        usage(argv[0]);
+        return 1;
+    }
+    string family = argv[1];
+    long vars = 0, holes = 0, vertices = 0;
+    int k = 3, colors = 3;
+    double ratio = 0, degree = 4.5;
+    bool unsat = false, planted = false;
+    uint64_t seed = 1;
+
+    for (int i = 2; i < argc; ++i) {
+        const char* a = argv[i];
+        if (!strncmp(a, "--vars=", 7)) { vars = atol(a + 7); }
+        else if (!strncmp(a, "--k=", 4)) { k = atoi(a + 4); }
+        else if (!strncmp(a, "--ratio=", 8)) { ratio = atof(a + 8); }
+        else if (!strncmp(a, "--seed=", 7)) { seed = strtoull(a + 7, nullptr, 10); }
+        else if (!strncmp(a, "--holes=", 8)) { holes = atol(a + 8); }
+        else if (!strncmp(a, "--vertices=", 11)) { vertices = atol(a + 11); }
+        else if (!strncmp(a, "--degree=", 9)) { degree = atof(a + 9); }
+        else if (!strncmp(a, "--colors=", 9)) { colors = atoi(a + 9); }
+        else if (!strcmp(a, "--unsat")) { unsat = true; }
+        else if (!strcmp(a, "--planted")) { planted = true; }
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    dimacs_sink out(stdout);
+    string description = "generated by:";
+    for (int i = 0; i < argc; ++i) { description += string(" ") + argv[i]; }
+    out.comment(description.c_str());
+
+    if (family == "ksat" && vars >= k && k > 0) {
+        random_ksat(out, vars, k, ratio > 0 ? ratio : ksat_threshold(k), seed);
+    }
+    else if (family == "php" && holes > 0) {
+        pigeonhole(out, holes);
+    }
+    else if (family == "parity" && vars > 1) {
+        parity_chains(out, vars, unsat, seed);
+    }
+    else if (family == "color" && vertices > 1 && colors > (planted ? 1 : 0)) {
+        graph_coloring(out, vertices, degree, colors, planted, seed);
+    }
+    else {
+        usage(argv[0]);
+        return 1;
+    }
+    return 0;
+}
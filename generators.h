@@ -0,0 +1,249 @@
+#ifndef GENERATORS_H
+#define GENERATORS_H
+
+#include "cnf.h"
+
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+// Seeded instance families for benchmarks and stress tests. Everything is
+// driven by our own generator (not <random>'s distributions, whose output
+// varies between standard libraries) so a seed means the same instance
+// everywhere.
+//
+// Each family streams its clauses into a Sink, which needs:
+//     void header(int vars, long clauses);
+//     void clause(const std::vector<int>& c);
+// with the literals as DIMACS numbers, so instances with millions of
+// variables never have to exist as a vector of clauses.
+
+// splitmix64: tiny, fast, and good enough for picking literals.
+class rng {
+    uint64_t state;
+public:
+    rng(uint64_t seed): state(seed) {}
+    uint64_t next() {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+    // Uniform in [0, n), by rejection so there's no modulo bias.
+    uint64_t below(uint64_t n) {
+        uint64_t limit = UINT64_MAX - (UINT64_MAX % n);
+        uint64_t x;
+        do { x = next(); } while (x >= limit);
+        return x % n;
+    }
+    bool coin() { return next() & 1; }
+};
+
+// Writes DIMACS through a large buffer; fprintf is far too slow once
+// we're writing tens of millions of literals.
+class dimacs_sink {
+    FILE* out;
+    std::vector<char> buffer;
+    void flush() {
+        fwrite(buffer.data(), 1, buffer.size(), out);
+        buffer.clear();
+    }
+    void put_int(long x) {
+        char digits[24];
+        int n = 0;
+        bool negative = x < 0;
+        unsigned long u = negative ? -x : x;
+        do {
+            digits[n++] = '0' + (u % 10);
+            u /= 10;
+        } while (u);
+        if (negative) { buffer.push_back('-'); }
+        while (n) { buffer.push_back(digits[--n]); }
+    }
+public:
+    dimacs_sink(FILE* out): out(out) { buffer.reserve(1 << 20); }
+    ~dimacs_sink() { flush(); fflush(out); }
+
+    void comment(const char* text) {
+        buffer.push_back('c');
+        buffer.push_back(' ');
+        while (*text) { buffer.push_back(*text++); }
+        buffer.push_back('\n');
+    }
+    void header(int vars, long clauses) {
+        const char p[] = "p cnf ";
+        buffer.insert(buffer.end(), p, p + sizeof(p) - 1);
+        put_int(vars);
+        buffer.push_back(' ');
+        put_int(clauses);
+        buffer.push_back('\n');
+    }
+    void clause(const std::vector<int>& c) {
+        for (int l : c) {
+            put_int(l);
+            buffer.push_back(' ');
+        }
+        buffer.push_back('0');
+        buffer.push_back('\n');
+        if (buffer.size() > (1 << 20) - 4096) { flush(); }
+    }
+};
+
+// Builds the solver's table directly, skipping DIMACS altogether.
+class cnf_sink {
+    std::vector<literal> lits;
+    std::vector<long> starts;
+    int vars = 0;
+public:
+    void header(int v, long clauses) {
+        vars = v;
+        starts.reserve(clauses + 1);
+    }
+    void clause(const std::vector<int>& c) {
+        starts.push_back(lits.size());
+        for (int x : c) { lits.push_back(literal::from_dimacs(x)); }
+    }
+    cnf take() {
+        starts.push_back(lits.size());
+        cnf result(std::max<long>(lits.size(), 1), std::max<long>(starts.size() - 1, 1), 2 * vars);
+        for (size_t i = 0; i + 1 < starts.size(); ++i) {
+            cnf::clause c{lits.data() + starts[i], lits.data() + starts[i + 1]};
+            result.insert_clause(c);
+        }
+        return result;
+    }
+};
+
+// The (approximate) satisfiability threshold of random k-SAT: 4.26 for
+// k = 3, and the first-moment estimate beyond that.
+double ksat_threshold(int k) {
+    if (k == 3) { return 4.26; }
+    if (k == 2) { return 1.0; }
+    return std::pow(2.0, k) * std::log(2.0) - (1 + std::log(2.0)) / 2;
+}
+
+// Uniform random k-SAT: k distinct variables per clause, random signs.
+template<typename Sink>
+void random_ksat(Sink& out, int vars, int k, double ratio, uint64_t seed) {
+    rng r(seed);
+    long clauses = std::lround(ratio * vars);
+    out.header(vars, clauses);
+    std::vector<int> c(k);
+    for (long i = 0; i < clauses; ++i) {
+        for (int j = 0; j < k; ++j) {
+            int v;
+            do {
+                v = 1 + r.below(vars);
+            } while (std::find(c.begin(), c.begin() + j, v) != c.begin() + j ||
+                     std::find(c.begin(), c.begin() + j, -v) != c.begin() + j);
+            c[j] = r.coin() ? v : -v;
+        }
+        out.clause(c);
+    }
+}
+
+// holes+1 pigeons into holes holes. Always unsat, and hard for resolution.
+template<typename Sink>
+void pigeonhole(Sink& out, int holes) {
+    const int pigeons = holes + 1;
+    auto p = [&](int pigeon, int hole) { return pigeon * holes + hole + 1; };
+    out.header(pigeons * holes, pigeons + static_cast<long>(holes) * pigeons * (pigeons - 1) / 2);
+    std::vector<int> c;
+    for (int i = 0; i < pigeons; ++i) {
+        c.clear();
+        for (int j = 0; j < holes; ++j) { c.push_back(p(i, j)); }
+        out.clause(c);
+    }
+    for (int j = 0; j < holes; ++j) {
+        for (int i = 0; i < pigeons; ++i) {
+            for (int i2 = i + 1; i2 < pigeons; ++i2) {
+                out.clause({-p(i, j), -p(i2, j)});
+            }
+        }
+    }
+}
+
+// c = a xor b, as the four clauses ruling out the odd assignments.
+template<typename Sink>
+void xor_gate(Sink& out, int c, int a, int b) {
+    out.clause({-c, a, b});
+    out.clause({-c, -a, -b});
+    out.clause({c, -a, b});
+    out.clause({c, a, -b});
+}
+
+// Two chains of xor gates computing the parity of the same n variables,
+// each in its own random order. Asserting the chains agree gives a
+// satisfiable instance; asserting they differ is unsat, but only by
+// reasoning about parity, which CDCL is notoriously bad at.
+template<typename Sink>
+void parity_chains(Sink& out, int n, bool unsat, uint64_t seed) {
+    rng r(seed);
+    // variables: x_1..x_n, then n-1 chain outputs for each chain.
+    const int vars = n + 2 * (n - 1);
+    out.header(vars, 8l * (n - 1) + 2);
+    int next = n + 1;
+    int outputs[2];
+    for (int chain = 0; chain < 2; ++chain) {
+        std::vector<int> order(n);
+        for (int i = 0; i < n; ++i) { order[i] = i + 1; }
+        for (int i = n - 1; i > 0; --i) { std::swap(order[i], order[r.below(i + 1)]); }
+        int acc = order[0];
+        for (int i = 1; i < n; ++i) {
+            int t = next++;
+            xor_gate(out, t, acc, order[i]);
+            acc = t;
+        }
+        outputs[chain] = acc;
+    }
+    // The first chain's parity is 1; the second must be 1 (sat) or 0 (unsat).
+    out.clause({outputs[0]});
+    out.clause({unsat ? -outputs[1] : outputs[1]});
+}
+
+// k-coloring of a random graph with the given average degree. If planted,
+// edges only join vertices of different hidden colors, so it's sat. The
+// hidden colors are dealt out round robin and shuffled, so every class is
+// used (as long as there are enough vertices) and there are edges to be had;
+// that needs colors >= 2.
+template<typename Sink>
+void graph_coloring(Sink& out, int vertices, double degree, int colors, bool planted, uint64_t seed) {
+    rng r(seed);
+    auto c = [&](int v, int i) { return v * colors + i + 1; };
+    std::vector<int> hidden(vertices);
+    for (int v = 0; v < vertices; ++v) { hidden[v] = v % colors; }
+    for (int i = vertices - 1; i > 0; --i) { std::swap(hidden[i], hidden[r.below(i + 1)]); }
+
+    long edges = std::lround(degree * vertices / 2);
+    std::vector<std::pair<int, int>> edge_list;
+    edge_list.reserve(edges);
+    while (static_cast<long>(edge_list.size()) < edges) {
+        int u = r.below(vertices), v = r.below(vertices);
+        if (u == v) { continue; }
+        if (planted && hidden[u] == hidden[v]) { continue; }
+        edge_list.push_back({u, v});
+    }
+
+    out.header(vertices * colors,
+               vertices + static_cast<long>(vertices) * colors * (colors - 1) / 2 + edges * colors);
+    std::vector<int> cl;
+    for (int v = 0; v < vertices; ++v) {
+        cl.clear();
+        for (int i = 0; i < colors; ++i) { cl.push_back(c(v, i)); }
+        out.clause(cl);
+        for (int i = 0; i < colors; ++i) {
+            for (int j = i + 1; j < colors; ++j) {
+                out.clause({-c(v, i), -c(v, j)});
+            }
+        }
+    }
+    for (auto e : edge_list) {
+        for (int i = 0; i < colors; ++i) {
+            out.clause({-c(e.first, i), -c(e.second, i)});
+        }
+    }
+}
+
+#endif
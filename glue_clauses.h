@@ -5,6 +5,7 @@
 
 #include "clause_map.h"
 #include "assignment.h"
+#include "stamped_set.h"
 
 class glue_clauses {
     public:
@@ -12,7 +13,8 @@ class glue_clauses {
 
     // these are essentially static values for calculating LBD.
     literal_map<int> literal_levels;
-    small_set<int> present_levels;
+    // Levels (shifted by one, for the root's -1) seen in the clause at hand.
+    stamped_set present_levels;
 
     // this is for computing the bottom half of the LBD
     // clauses we want to keep. Note a clause cannot have LBD
@@ -26,12 +28,14 @@ class glue_clauses {
     template<typename C>
     int calculate_lbd(const assignment& a,
                       const C& cl) {
+        PROFILE_SCOPE(phase_lbd);
         present_levels.clear();
+        int count = 0;
         for (auto x : cl) {
             ASSERT(a.is_false(x));
-            present_levels.insert(a.decision_level(-x));
+            count += present_levels.insert(a.decision_level(-x) + 1);
         }
-        return present_levels.size();
+        return count;
     }
 
     std::pair<int,int> compute_cutoff_values(const cnf& c) {
@@ -63,7 +67,8 @@ class glue_clauses {
                 seen_so_far += lbd_buckets[i];
             }
         }
-        ASSERT(max_count > 0); // this means we've broken out of the loop.
+        // (0 if the lower LBDs make up exactly half, which can happen.)
+        ASSERT(max_count >= 0);
         ASSERT(max_lbd); // now we're in trouble...
         int recounter = max_count;
         for (int i = 0; i < max_lbd; ++i) {
@@ -76,12 +81,15 @@ class glue_clauses {
     }
 
     std::unique_ptr<int[]> generate_mapping(const cnf& c, const assignment& a, int& new_index) {
+        PROFILE_SCOPE(phase_reduce);
         int max_lbd, max_count;
         std::tie(max_lbd, max_count) = compute_cutoff_values(c);
         //printf("cutoff: %d %d\n", max_lbd, max_count);
 
-        auto m = std::make_unique<int[]>(c.clauses_count);
-        std::fill(m.get(), m.get()+c.clauses_count, 0);
+        // The clause_maps walk the whole mapping (up to clauses_max), so
+        // everything past the live clauses is marked as removed.
+        auto m = std::make_unique<int[]>(c.clauses_max);
+        std::fill(m.get(), m.get()+c.clauses_max, -1);
 
         // clause_end is the number of *valid* clauses.
         //printf("Computing m index for #%ld %d\n", std::distance(c.clause_begin(), c.clause_end()), c.clauses_count);
@@ -105,6 +113,7 @@ class glue_clauses {
     glue_clauses(cnf& c):
         lbd(c, c.clauses_max, c.clauses.get()),
         literal_levels(c.max_literal_count),
+        present_levels(c.max_literal_count / 2 + 2),
         lbd_buckets(std::make_unique<int[]>(c.max_literal_count)),
         literal_count(c.max_literal_count),
         current_clause_count(c.clauses_count*4) // * 2 is a quick way of avoiding trying to delete 0-lbd-score clauses (i.e., clauses we must keep in).
@@ -0,0 +1,281 @@
+"""Benchmark harness for sat.
+
+    Bench.py run SUITE [--repeat N] [--timeout S] [--out PREFIX] [--baseline FILE] [--sat ./sat]
+    Bench.py compare BASELINE.json NEW.json [--alpha A] [--threshold T]
+
+"run" solves every instance in the suite --repeat times and writes
+PREFIX.csv (one row per run) and PREFIX.json (per-instance summaries plus
+the raw samples). With --baseline it then compares against that JSON.
+
+A suite file has one group per line:
+
+    group   glob                  source
+    uf75    inputs/uf75-*.cnf     fetch https://.../uf75-325.tar.gz
+    k3-200  inputs/gen/k3-200-*.cnf  gen 10 ksat --vars=200
+    looper  tests/looper*.cnf     local
+
+If a group's glob matches nothing, "fetch" downloads and unpacks the
+tarball into the glob's directory, and "gen N ARGS" runs ./gen ARGS with
+seeds 1..N, naming each instance by putting the seed in place of the '*'. Anything after the source keyword is
+passed along, so new kinds of sources can be added in prepare().
+"""
+import sys
+import os
+import glob
+import json
+import math
+import time
+import tarfile
+import tempfile
+import subprocess
+import urllib.request
+import argparse
+
+
+def load_suite(path):
+    groups = []
+    for line in open(path):
+        line = line.split('#')[0].strip()
+        if not line:
+            continue
+        words = line.split()
+        groups.append({'group': words[0], 'glob': words[1], 'source': words[2:]})
+    return groups
+
+
+def fetch(url, directory):
+    os.makedirs(directory, exist_ok=True)
+    with tempfile.NamedTemporaryFile(suffix='.tar.gz') as tmp:
+        print('fetching', url, file=sys.stderr)
+        urllib.request.urlretrieve(url, tmp.name)
+        with tarfile.open(tmp.name) as tar:
+            # Flatten: some SATLIB tarballs put everything in a subdirectory.
+            for member in tar.getmembers():
+                if member.isfile() and member.name.endswith('.cnf'):
+                    member.name = os.path.basename(member.name)
+                    tar.extract(member, directory)
+
+
+def generate(pattern, count, args):
+    os.makedirs(os.path.dirname(pattern) or '.', exist_ok=True)
+    for seed in range(1, count + 1):
+        with open(pattern.replace('*', str(seed)), 'w') as out:
+            subprocess.run(['./gen'] + args + ['--seed=%d' % seed], stdout=out, check=True)
+
+
+def prepare(group):
+    files = sorted(glob.glob(group['glob']))
+    if files:
+        return files
+    kind = group['source'][0] if group['source'] else 'local'
+    if kind == 'fetch':
+        fetch(group['source'][1], os.path.dirname(group['glob']) or '.')
+    elif kind == 'gen':
+        generate(group['glob'], int(group['source'][1]), group['source'][2:])
+    files = sorted(glob.glob(group['glob']))
+    if not files:
+        print('warning: no instances for group', group['group'], file=sys.stderr)
+    return files
+
+
+def run_once(sat, path, timeout):
+    """Returns a dict with wall time, result, counters and peak RSS."""
+    with tempfile.NamedTemporaryFile(suffix='.json') as stats_file:
+        start = time.time()
+        with open(path) as f:
+            p = subprocess.Popen([sat, '--stats-json=' + stats_file.name],
+                                 stdin=f, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+        timed_out = False
+        try:
+            out, _ = p.communicate(timeout=timeout)
+        except subprocess.TimeoutExpired:
+            p.kill()
+            out, _ = p.communicate()
+            timed_out = True
+        wall = time.time() - start
+        # The counters and peak RSS come from the solver's own
+        # --stats-json; a run that timed out has none.
+        row = {'wall': wall, 'timeout': timed_out,
+               'result': out.decode().strip().split('\n')[0] if out else ''}
+        try:
+            stats = json.load(open(stats_file.name))
+        except (ValueError, OSError):
+            stats = {}
+        row['conflicts'] = stats.get('conflicts', '')
+        row['propagations'] = stats.get('propagations', '')
+        row['decisions'] = stats.get('decisions', '')
+        row['peak_rss_kb'] = stats.get('peak_rss_kb', '')
+        return row
+
+
+def mean(xs):
+    return sum(xs) / len(xs)
+
+
+def stdev(xs):
+    if len(xs) < 2:
+        return 0.0
+    m = mean(xs)
+    return math.sqrt(sum((x - m) ** 2 for x in xs) / (len(xs) - 1))
+
+
+def betacf(a, b, x):
+    # Continued fraction for the incomplete beta function (Numerical Recipes).
+    qab, qap, qam = a + b, a + 1, a - 1
+    c, d = 1.0, 1 - qab * x / qap
+    d = 1 / (d if abs(d) > 1e-30 else 1e-30)
+    h = d
+    for m in range(1, 200):
+        m2 = 2 * m
+        aa = m * (b - m) * x / ((qam + m2) * (a + m2))
+        d = 1 + aa * d
+        d = 1 / (d if abs(d) > 1e-30 else 1e-30)
+        c = 1 + aa / c if abs(c) > 1e-30 else 1e30
+        h *= d * c
+        aa = -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2))
+        d = 1 + aa * d
+        d = 1 / (d if abs(d) > 1e-30 else 1e-30)
+        c = 1 + aa / c if abs(c) > 1e-30 else 1e30
+        delta = d * c
+        h *= delta
+        if abs(delta - 1) < 1e-12:
+            break
+    return h
+
+
+def incomplete_beta(a, b, x):
+    if x <= 0:
+        return 0.0
+    if x >= 1:
+        return 1.0
+    front = math.exp(math.lgamma(a + b) - math.lgamma(a) - math.lgamma(b) +
+                     a * math.log(x) + b * math.log(1 - x))
+    if x < (a + 1) / (a + b + 2):
+        return front * betacf(a, b, x) / a
+    return 1 - front * betacf(b, a, 1 - x) / b
+
+
+def welch_p(xs, ys):
+    """Two-sided p-value of Welch's t-test; 1.0 if we can't tell."""
+    if len(xs) < 2 or len(ys) < 2:
+        return 1.0
+    vx, vy = stdev(xs) ** 2 / len(xs), stdev(ys) ** 2 / len(ys)
+    if vx + vy == 0:
+        return 0.0 if mean(xs) != mean(ys) else 1.0
+    t = (mean(xs) - mean(ys)) / math.sqrt(vx + vy)
+    df = (vx + vy) ** 2 / ((vx ** 2) / (len(xs) - 1) + (vy ** 2) / (len(ys) - 1))
+    return incomplete_beta(df / 2, 0.5, df / (df + t * t))
+
+
+def summarize(rows):
+    summary = {}
+    for r in rows:
+        s = summary.setdefault(r['instance'], {'group': r['group'], 'wall': [],
+                                               'conflicts': [], 'propagations': [],
+                                               'peak_rss_kb': [], 'results': set()})
+        s['wall'].append(r['wall'])
+        for k in ('conflicts', 'propagations', 'peak_rss_kb'):
+            if r[k] != '':
+                s[k].append(r[k])
+        s['results'].add('timeout' if r['timeout'] else r['result'])
+    for s in summary.values():
+        s['results'] = sorted(s['results'])
+        s['mean_wall'] = mean(s['wall'])
+        s['stdev_wall'] = stdev(s['wall'])
+    return summary
+
+
+def compare(baseline, new, alpha, threshold):
+    """Print per-group and per-instance changes; return the regressions."""
+    regressions = []
+    groups = {}
+    for name, s in sorted(new['instances'].items()):
+        b = baseline['instances'].get(name)
+        if not b:
+            continue
+        ratio = s['mean_wall'] / b['mean_wall'] if b['mean_wall'] > 0 else 1.0
+        p = welch_p(s['wall'], b['wall'])
+        g = groups.setdefault(s['group'], [])
+        g.append(ratio)
+        if b['results'] != s['results']:
+            print('RESULT CHANGED %s: %s -> %s' % (name, b['results'], s['results']))
+            regressions.append(name)
+        if p < alpha and ratio > 1 + threshold:
+            print('REGRESSION %-30s %8.3fs -> %8.3fs (x%.2f, p=%.3g)' %
+                  (name, b['mean_wall'], s['mean_wall'], ratio, p))
+            regressions.append(name)
+        elif p < alpha and ratio < 1 - threshold:
+            print('improved   %-30s %8.3fs -> %8.3fs (x%.2f, p=%.3g)' %
+                  (name, b['mean_wall'], s['mean_wall'], ratio, p))
+    for group, ratios in sorted(groups.items()):
+        geo = math.exp(sum(math.log(max(r, 1e-9)) for r in ratios) / len(ratios))
+        print('group %-12s geometric mean time ratio x%.3f over %d instances' %
+              (group, geo, len(ratios)))
+    return regressions
+
+
+def cmd_run(args):
+    rows = []
+    for group in load_suite(args.suite):
+        for path in prepare(group):
+            for rep in range(args.repeat):
+                row = run_once(args.sat, path, args.timeout)
+                row.update({'group': group['group'], 'instance': path, 'repeat': rep})
+                rows.append(row)
+            print('%-12s %-40s %8.3fs %s' % (group['group'], path,
+                  mean([r['wall'] for r in rows if r['instance'] == path]),
+                  rows[-1]['result']), file=sys.stderr)
+
+    columns = ['group', 'instance', 'repeat', 'wall', 'timeout', 'result',
+               'conflicts', 'propagations', 'decisions', 'peak_rss_kb']
+    with open(args.out + '.csv', 'w') as csv:
+        csv.write(','.join(columns) + '\n')
+        for r in rows:
+            csv.write(','.join(str(r[c]) for c in columns) + '\n')
+    result = {'suite': args.suite, 'repeat': args.repeat, 'sat': args.sat,
+              'instances': summarize(rows)}
+    with open(args.out + '.json', 'w') as out:
+        json.dump(result, out, indent=1, sort_keys=True)
+
+    total = sum(r['wall'] for r in rows) / args.repeat
+    print('total %.3fs per repetition; wrote %s.csv and %s.json' % (total, args.out, args.out))
+    if args.baseline:
+        regressions = compare(json.load(open(args.baseline)), result, args.alpha, args.threshold)
+        return 1 if regressions else 0
+    return 0
+
+
+def cmd_compare(args):
+    regressions = compare(json.load(open(args.baseline)), json.load(open(args.new)),
+                          args.alpha, args.threshold)
+    return 1 if regressions else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description='sat benchmark harness')
+    sub = parser.add_subparsers(dest='command')
+    run = sub.add_parser('run')
+    run.add_argument('suite')
+    run.add_argument('--repeat', type=int, default=5)
+    run.add_argument('--timeout', type=float, default=300)
+    run.add_argument('--out', default='bench_results')
+    run.add_argument('--sat', default='./sat')
+    run.add_argument('--baseline')
+    run.add_argument('--alpha', type=float, default=0.01)
+    run.add_argument('--threshold', type=float, default=0.05)
+    cmp = sub.add_parser('compare')
+    cmp.add_argument('baseline')
+    cmp.add_argument('new')
+    cmp.add_argument('--alpha', type=float, default=0.01)
+    cmp.add_argument('--threshold', type=float, default=0.05)
+    args = parser.parse_args()
+    if args.command == 'run':
+        return cmd_run(args)
+    if args.command == 'compare':
+        return cmd_compare(args)
+    parser.print_help()
+    return 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -2,58 +2,105 @@
 #define LITERAL_MAP_H
 
 #include "debug.h"
+#include "page_alloc.h"
 
 #include <memory>
+#include <cstdlib>
+#include <iostream>
 
-typedef int literal;
+// Internally a literal is 2*var + sign, so variable v is 2v and its
+// negation is 2v+1. Negation is an xor, the encoding is directly an
+// array index, and 0 is left over to mean "no literal". DIMACS numbers
+// only exist at the edges: the parser, the proof writers, and printing.
+class literal {
+    unsigned code = 0;
+public:
+    literal() = default;
+    explicit constexpr literal(unsigned code): code(code) {}
+
+    static literal from_dimacs(int d) {
+        return literal(2u * std::abs(d) + (d < 0 ? 1u : 0u));
+    }
+    static literal positive(int var) { return literal(2u * var); }
+    int to_dimacs() const {
+        int v = code >> 1;
+        return (code & 1) ? -v : v;
+    }
+
+    literal operator-() const { return literal(code ^ 1u); }
+    unsigned index() const { return code; }
+    int var() const { return code >> 1; }
+    bool is_negative() const { return code & 1u; }
+    explicit operator bool() const { return code != 0; }
+
+    bool operator==(literal o) const { return code == o.code; }
+    bool operator!=(literal o) const { return code != o.code; }
+    bool operator<(literal o) const { return code < o.code; }
+};
 
-// Exploit the fact that literals are easily mapped to array indices
-// to get an efficient "map", literal->T.
+std::ostream& operator<<(std::ostream& o, literal l) { return o << l.to_dimacs(); }
+
+// Exploit the fact that literals are array indices to get an efficient
+// "map", literal->T. It's built from the number of literals (2 * the
+// number of variables); slots 0 and 1 (no variable 0) just go unused.
+// There are 3 more slots past the end so vector code can do 4-byte loads
+// at any index (clause_scan.h).
 template <typename T>
 class literal_map {
-    std::unique_ptr<T[]> data;
+    big_array<T> data;
     const int size;
 
 public:
-
-    static int literal_to_index(literal i) {
-        int index = ((2*std::abs(i))-1) - ((i < 0) ? 1 : 0);
-        return index;
-    }
-
-    static literal index_to_literal(int i) {
-        if (i % 2) { return ((i + 1) / 2); }
-        else { return -((i + 2) / 2); }
-    }
-
-    literal_map(size_t s): data(std::make_unique<T[]>(s)), size(s) {
+    literal_map(size_t s): data(make_big_array<T>(s + 2 + 3)), size(s + 2) {
         std::fill(data.get(), data.get()+size, T());
     }
 
-    T& operator[](literal i) {
-        // TODO: maybe have a different access pattern, or different
-        // iteration pattern, because of potential cache misses. Do we
-        // group (x, -x) closely, or (x, x+1) closely?
-        int index = literal_to_index(i);
-        return data[index];
+    T& operator[](literal l) {
+        ASSERT(l.index() >= 2 && l.index() < unsigned(size));
+        return data[l.index()];
     }
-    T get_copy(literal i) const {
-        // TODO: maybe have a different access pattern, or different
-        // iteration pattern, because of potential cache misses. Do we
-        // group (x, -x) closely, or (x, x+1) closely?
-        int index = literal_to_index(i);
-        if (index < 0 || index >= size) { TRACE("BAD INDEX: ", index, " ", i, "\n"); }
-        ASSERT(index >= 0 && index < size);
-        return data[index];
+    const T& operator[](literal l) const {
+        ASSERT(l.index() >= 2 && l.index() < unsigned(size));
+        return data[l.index()];
     }
+    T get_copy(literal l) const { return (*this)[l]; }
 
     // Rather than maintain complicated iterator structures, we'll just iterate
-    // using the C-style for-loop and keep things consistent.
-    int first_index() const { return -(size/2); }
-    int end_index() const { return (size/2)+1; }
+    // over the indices with a C-style for-loop, literal(i) being the literal.
+    unsigned first_index() const { return 2; }
+    unsigned end_index() const { return size; }
 
     T* first_value_iter() { return data.get(); }
+    const T* first_value_iter() const { return data.get(); }
     T* last_value_iter() { return data.get()+size; }
 };
 
+// The same, for variables 1..n; built from the number of literals too.
+template <typename T>
+class variable_map {
+    big_array<T> data;
+    const int size;
+
+public:
+    variable_map(size_t literal_count):
+        data(make_big_array<T>(literal_count / 2 + 1)),
+        size(literal_count / 2 + 1) {
+        std::fill(data.get(), data.get()+size, T());
+    }
+
+    T& operator[](int v) {
+        ASSERT(v >= 1 && v < size);
+        return data[v];
+    }
+    const T& operator[](int v) const {
+        ASSERT(v >= 1 && v < size);
+        return data[v];
+    }
+    T& operator[](literal l) { return (*this)[l.var()]; }
+    const T& operator[](literal l) const { return (*this)[l.var()]; }
+
+    int first_index() const { return 1; }
+    int end_index() const { return size; }
+};
+
 #endif
@@ -0,0 +1,259 @@
+#ifndef LOCAL_SEARCH_H
+#define LOCAL_SEARCH_H
+
+#include "cnf.h"
+#include "assignment.h"
+#include "generators.h"
+#include "stats.h"
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+// ProbSAT (Balint and Schoening): start from a full assignment, and
+// while some clause is false, pick one at random and flip one of its
+// variables, choosing variable v with probability proportional to
+// (eps + break(v))^-cb, where break(v) is how many clauses only v makes
+// true. On satisfiable random k-SAT this finds a model far sooner than
+// CDCL does; it can never say "unsat", though.
+//
+// It keeps its own copy of the input clauses (learned clauses aren't
+// worth walking over), with the occurrence lists in one array per
+// literal sign, CSR style. Per clause we keep the number of true literals
+// and the xor of their variables, which is the single true variable
+// whenever that count is 1, so break counts update incrementally on
+// each flip.
+class probsat {
+    int vars;
+    // The literals of clause i are lits[start[i]] .. lits[start[i+1]].
+    std::vector<literal> lits;
+    std::vector<int> start;
+    // The clauses containing literal l are occ[occ_start[l] .. occ_start[l+1]].
+    std::vector<int> occ_start, occ;
+
+    std::vector<unsigned char> value; // per variable: 1 true, 0 false
+    std::vector<int> true_count, critical;
+    std::vector<int> break_count;
+    // The false clauses, and where each sits in that list.
+    std::vector<int> unsat, where;
+    std::vector<double> break_weight;
+    rng random;
+
+    std::vector<unsigned char> best;
+    size_t best_unsat = -1;
+
+    bool is_true(literal l) const { return value[l.var()] != l.is_negative(); }
+
+    void make_unsat(int ci) {
+        where[ci] = unsat.size();
+        unsat.push_back(ci);
+    }
+    void make_sat(int ci) {
+        int last = unsat.back();
+        unsat[where[ci]] = last;
+        where[last] = where[ci];
+        unsat.pop_back();
+    }
+
+    void flip(int v) {
+        value[v] ^= 1;
+        const literal t = value[v] ? literal::positive(v) : -literal::positive(v);
+        const literal f = -t;
+        for (int i = occ_start[t.index()]; i < occ_start[t.index() + 1]; ++i) {
+            const int ci = occ[i];
+            const int n = ++true_count[ci];
+            if (n == 1) {
+                make_sat(ci);
+                break_count[v]++;
+            }
+            else if (n == 2) {
+                break_count[critical[ci]]--;
+            }
+            critical[ci] ^= v;
+        }
+        for (int i = occ_start[f.index()]; i < occ_start[f.index() + 1]; ++i) {
+            const int ci = occ[i];
+            const int n = --true_count[ci];
+            critical[ci] ^= v;
+            if (n == 0) {
+                make_unsat(ci);
+                break_count[v]--;
+            }
+            else if (n == 1) {
+                break_count[critical[ci]]++;
+            }
+        }
+        flips++;
+    }
+
+    // Recompute everything from value.
+    void reset() {
+        std::fill(break_count.begin(), break_count.end(), 0);
+        unsat.clear();
+        const int clause_count = start.size() - 1;
+        for (int ci = 0; ci < clause_count; ++ci) {
+            true_count[ci] = 0;
+            critical[ci] = 0;
+            for (int i = start[ci]; i < start[ci + 1]; ++i) {
+                if (is_true(lits[i])) {
+                    true_count[ci]++;
+                    critical[ci] ^= lits[i].var();
+                }
+            }
+            if (true_count[ci] == 0) { make_unsat(ci); }
+            else if (true_count[ci] == 1) { break_count[critical[ci]]++; }
+        }
+        best_unsat = -1;
+        note_best();
+    }
+
+    void note_best() {
+        if (unsat.size() >= best_unsat) { return; }
+        best_unsat = unsat.size();
+        best = value;
+    }
+
+public:
+    long flips = 0;
+    // We can't do anything with an empty clause.
+    bool usable = true;
+
+    probsat(const cnf& c, uint64_t seed = 1):
+        vars(c.max_literal_count / 2),
+        occ_start(c.max_literal_count + 3, 0),
+        value(vars + 1, 0),
+        true_count(c.clauses_count),
+        critical(c.clauses_count),
+        break_count(vars + 1),
+        where(c.clauses_count),
+        random(seed)
+    {
+        int longest = 0;
+        start.push_back(0);
+        for (auto cit = c.clause_begin(); cit != c.clause_end(); ++cit) {
+            if (size(cit) == 0) { usable = false; }
+            longest = std::max(longest, size(cit));
+            for (literal l : cit) {
+                lits.push_back(l);
+                occ_start[l.index() + 1]++;
+            }
+            start.push_back(lits.size());
+        }
+        for (size_t i = 1; i < occ_start.size(); ++i) { occ_start[i] += occ_start[i - 1]; }
+        occ.resize(lits.size());
+        std::vector<int> fill(occ_start.begin(), occ_start.end() - 1);
+        for (size_t ci = 0; ci + 1 < start.size(); ++ci) {
+            for (int i = start[ci]; i < start[ci + 1]; ++i) { occ[fill[lits[i].index()]++] = ci; }
+        }
+
+        // The polynomial break weights from the ProbSAT paper, by clause
+        // length; longer clauses want a greedier walk.
+        const double cb = longest <= 3 ? 2.38 : longest == 4 ? 3.0 : longest == 5 ? 3.7 :
+                          longest == 6 ? 5.1 : 5.4;
+        const double eps = 1.0;
+        for (int b = 0; b < 64; ++b) { break_weight.push_back(std::pow(eps + b, -cb)); }
+
+        for (int v = 1; v <= vars; ++v) { value[v] = random.coin(); }
+        reset();
+    }
+
+    // Start again from the best assignment so far, overridden by these
+    // literals (e.g., the CDCL trail).
+    template<typename It>
+    void start_from(It b, It e) {
+        if (!best.empty()) { value = best; }
+        for (; b != e; ++b) { value[b->var()] = !b->is_negative(); }
+        reset();
+    }
+
+    // Walk until we find a model or run out of flips. True if we found one.
+    bool run(long max_flips) {
+        PROFILE_SCOPE(phase_local_search);
+        if (!usable) { return false; }
+        std::vector<double> weights;
+        const long limit = flips + max_flips;
+        while (!unsat.empty() && flips < limit) {
+            const int ci = unsat[random.below(unsat.size())];
+            weights.clear();
+            double total = 0;
+            for (int i = start[ci]; i < start[ci + 1]; ++i) {
+                const int b = std::min<int>(break_count[lits[i].var()], break_weight.size() - 1);
+                total += break_weight[b];
+                weights.push_back(total);
+            }
+            const double x = total * (random.next() >> 11) * (1.0 / (1ull << 53));
+            int pick = 0;
+            while (pick + 1 < int(weights.size()) && weights[pick] <= x) { pick++; }
+            flip(lits[start[ci] + pick].var());
+            note_best();
+        }
+        return unsat.empty();
+    }
+
+    size_t unsat_count() const { return unsat.size(); }
+
+    // The best assignment so far (a model, if run() returned true).
+    std::vector<literal> best_assignment() const {
+        std::vector<literal> result;
+        for (int v = 1; v <= vars; ++v) {
+            result.push_back(best[v] ? literal::positive(v) : -literal::positive(v));
+        }
+        return result;
+    }
+};
+
+// Local search policies for the solver: one gets a turn before the CDCL
+// search starts and at each restart. If it finds a model, that's the
+// answer; otherwise it hands its best assignment to the heuristic as
+// saved phases.
+
+// What we've always done.
+struct no_local_search {
+    no_local_search(const cnf&) {}
+    template<typename Heuristic>
+    bool before_search(Heuristic&, statistics&, std::vector<literal>&) { return false; }
+    template<typename Heuristic>
+    bool on_restart(const assignment&, Heuristic&, statistics&, std::vector<literal>&) { return false; }
+};
+
+// ProbSAT first, for a budget of flips per variable. At each restart,
+// a shorter walk from the trail we're abandoning (with the best
+// assignment so far filling in the rest).
+class probsat_phases {
+    probsat walker;
+    const long first_budget, restart_budget;
+
+    template<typename Heuristic>
+    bool finish(Heuristic& v, statistics& stats, std::vector<literal>& model, long flips_before, bool found) {
+        STAT(stats.flips += walker.flips - flips_before);
+        (void)stats;
+        (void)flips_before;
+        if (found) {
+            model = walker.best_assignment();
+            return true;
+        }
+        for (literal l : walker.best_assignment()) { v.set_phase(l); }
+        return false;
+    }
+
+public:
+    probsat_phases(const cnf& c):
+        walker(c),
+        first_budget(1000l * (c.max_literal_count / 2) + 10000),
+        restart_budget(first_budget / 10) {}
+
+    template<typename Heuristic>
+    bool before_search(Heuristic& v, statistics& stats, std::vector<literal>& model) {
+        const long flips_before = walker.flips;
+        return finish(v, stats, model, flips_before, walker.run(first_budget));
+    }
+
+    template<typename Heuristic>
+    bool on_restart(const assignment& a, Heuristic& v, statistics& stats, std::vector<literal>& model) {
+        const long flips_before = walker.flips;
+        walker.start_from(a.begin(), a.end());
+        return finish(v, stats, model, flips_before, walker.run(restart_budget));
+    }
+};
+
+#endif
@@ -0,0 +1,174 @@
+#ifndef LRB_H
+#define LRB_H
+
+#include "literal_map.h"
+#include "assignment.h"
+#include "decision_heap.h"
+#include "stats.h"
+#include "profiler.h"
+#include "checkpoint.h"
+
+#include <cmath>
+#include <vector>
+
+// Learning-rate branching (Liang, Ganesh, Poupart and Czarnecki, SAT 2016).
+// Branching is treated as a bandit problem: a variable's reward for one
+// stretch of being assigned is its learning rate, the fraction of the
+// conflicts in that stretch whose analysis it took part in. Its score is
+// an exponential recency-weighted average of those rewards, updated when
+// it's unassigned, and we decide on the best-scoring unassigned variable.
+//
+// With the paper's two extensions:
+//   reason side rate: variables in the reasons of the learned clause's
+//     literals (so close to the conflict, but resolved away before it)
+//     count towards the reward too;
+//   locality: each conflict an unassigned variable sits through decays
+//     its score by 0.95. We do this lazily, when it comes up at the top
+//     of the heap.
+//
+// Polarity is the saved phase, as for vmtf.
+class lrb {
+    const int variables;
+    std::vector<double> score;
+    decision_heap heap;
+
+    // The step size alpha starts at 0.4 and comes down by 1e-6 a conflict
+    // to 0.06.
+    double alpha = 0.4;
+    // A conflict counts from its analysis on, so that what the backjump
+    // unassigns gets credit for it.
+    unsigned long conflicts = 0;
+    bool analyzing = false;
+
+    // Per variable: the conflict count when it was assigned (or, for the
+    // locality decay, last decayed), and how many conflicts since then it
+    // took part in, or was on the reason side of.
+    std::vector<unsigned long> assigned_at, decayed_at;
+    std::vector<unsigned> participated, reasoned;
+
+    // Which variables we've counted this conflict.
+    std::vector<unsigned long> seen;
+
+    variable_map<signed char> phase;
+
+    void begin_conflict() {
+        if (analyzing) { return; }
+        analyzing = true;
+        conflicts++;
+        if (alpha > 0.06) { alpha -= 1e-6; }
+    }
+
+    void participate(int v) {
+        if (seen[v] == conflicts) { return; }
+        seen[v] = conflicts;
+        participated[v]++;
+    }
+
+    public:
+    lrb(const cnf& c, statistics&):
+        variables(c.max_literal_count / 2),
+        score(variables + 1, 0.0),
+        heap(score, variables),
+        assigned_at(variables + 1),
+        decayed_at(variables + 1),
+        participated(variables + 1),
+        reasoned(variables + 1),
+        seen(variables + 1),
+        phase(c.max_literal_count)
+    {
+        for (int v = 1; v <= variables; ++v) {
+            heap.insert(v);
+            phase[literal::positive(v)] = -1;
+        }
+    }
+
+    literal get_literal(const assignment& a) {
+        PROFILE_SCOPE(phase_decide);
+        while (!heap.empty()) {
+            const int v = heap.top();
+            if (!a.is_unassigned(literal::positive(v))) {
+                heap.pop();
+                continue;
+            }
+            const unsigned long age = conflicts - decayed_at[v];
+            if (age > 0) {
+                score[v] *= std::pow(0.95, age);
+                decayed_at[v] = conflicts;
+                heap.update(v);
+                continue;
+            }
+            const literal l = literal::positive(v);
+            return phase[l] < 0 ? -l : l;
+        }
+        return literal();
+    }
+
+    void set_phase(literal l) { phase[l] = l.is_negative() ? -1 : 1; }
+
+    void assigned(literal l) {
+        const int v = l.var();
+        assigned_at[v] = conflicts;
+        participated[v] = 0;
+        reasoned[v] = 0;
+    }
+
+    void analyzed(cnf::clause_iterator reason) {
+        begin_conflict();
+        for (literal l : reason) { participate(l.var()); }
+    }
+
+    // By now the solver has backjumped and asserted the clause's UIP, so
+    // the rest of its literals are still false with their reasons intact.
+    void learned(const assignment& a, cnf::clause_iterator c) {
+        begin_conflict();
+        for (literal l : c) { participate(l.var()); }
+        for (literal l : c) {
+            if (!a.is_false(l)) { continue; }
+            const auto reason = a.reason_of(-l);
+            if (!reason) { continue; }
+            for (literal r : reason) {
+                const int v = r.var();
+                if (seen[v] == conflicts) { continue; }
+                seen[v] = conflicts;
+                reasoned[v]++;
+            }
+        }
+        analyzing = false;
+    }
+
+    // The end of a stretch: score it, and back in the heap.
+    void unassigned(const literal* b, const literal* e) {
+        for (; b != e; ++b) {
+            const int v = b->var();
+            phase[literal::positive(v)] = b->is_negative() ? -1 : 1;
+            const unsigned long interval = conflicts - assigned_at[v];
+            if (interval > 0) {
+                const double reward = double(participated[v] + reasoned[v]) / interval;
+                score[v] = (1 - alpha) * score[v] + alpha * reward;
+            }
+            decayed_at[v] = conflicts;
+            if (heap.contains(v)) { heap.update(v); }
+            else { heap.insert(v); }
+        }
+    }
+
+    bool should_restart() { return false; }
+
+    // For checkpoint.h: the scores, step size and phases. We load at the
+    // root with nothing assigned, so the per-stretch counts start over.
+    void save(checkpoint_writer& out) const {
+        out.put_double(alpha);
+        for (int v = 1; v <= variables; ++v) { out.put_double(score[v]); }
+        for (int v = 1; v <= variables; ++v) { out.put_signed(phase[v]); }
+    }
+    void load(checkpoint_reader& in) {
+        alpha = in.get_double();
+        for (int v = 1; v <= variables; ++v) {
+            score[v] = in.get_double();
+            heap.update(v);
+        }
+        for (int v = 1; v <= variables; ++v) { phase[v] = in.get_signed(); }
+    }
+};
+
+#endif
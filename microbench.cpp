@@ -0,0 +1,326 @@
+#include "solver.h"
+#include "dimacs.h"
+#include "generators.h"
+#include "renumber.h"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <chrono>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// Hardware counters through perf_event_open, where the kernel lets us.
+// If it doesn't (containers, paranoid settings, other OSes) we just
+// report time and cycles.
+class perf_counters {
+public:
+    static const int count = 4;
+    const char* names[count] = {"instr", "cache-miss", "branch-miss", "L1d-miss"};
+    long values[count] = {0};
+    bool available = false;
+
+private:
+    int fds[count];
+
+#ifdef __linux__
+    static int open_counter(uint32_t type, uint64_t config) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+#endif
+
+public:
+    perf_counters() {
+        std::fill(fds, fds + count, -1);
+#ifdef __linux__
+        fds[0] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        fds[1] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        fds[2] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        fds[3] = open_counter(PERF_TYPE_HW_CACHE,
+                              PERF_COUNT_HW_CACHE_L1D |
+                              (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+        available = std::all_of(fds, fds + count, [](int fd) { return fd >= 0; });
+#endif
+    }
+    ~perf_counters() {
+#ifdef __linux__
+        for (int fd : fds) { if (fd >= 0) { close(fd); } }
+#endif
+    }
+    void start() {
+#ifdef __linux__
+        if (!available) { return; }
+        for (int fd : fds) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+    void stop() {
+#ifdef __linux__
+        if (!available) { return; }
+        for (int i = 0; i < count; ++i) {
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+            long long v = 0;
+            if (read(fds[i], &v, sizeof(v)) == sizeof(v)) { values[i] = v; }
+        }
+#endif
+    }
+};
+
+unsigned long long cycles_now() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Run `batch` reps times; each call returns how many operations it did.
+template<typename F>
+void measure(const char* name, int reps, perf_counters& pc, F batch) {
+    batch(); // warm the caches and the branch predictors.
+    long ops = 0;
+    pc.start();
+    auto t0 = chrono::steady_clock::now();
+    auto c0 = cycles_now();
+    for (int i = 0; i < reps; ++i) { ops += batch(); }
+    auto c1 = cycles_now();
+    auto t1 = chrono::steady_clock::now();
+    pc.stop();
+
+    double ns = chrono::duration<double, nano>(t1 - t0).count();
+    cout << left << setw(22) << name << right
+         << setw(12) << ops
+         << setw(12) << fixed << setprecision(1) << ns / max(ops, 1l)
+         << setw(12) << double(c1 - c0) / max(ops, 1l);
+    for (int i = 0; i < pc.count; ++i) {
+        if (pc.available) { cout << setw(15) << double(pc.values[i]) / max(ops, 1l); }
+        else { cout << setw(15) << "n/a"; }
+    }
+    cout << endl;
+}
+
+// A solver state frozen just as BCP finds a conflict: decisions come from
+// vsids and propagation from watched_literals, exactly as in solve(), but
+// without learning so the state is reproducible. We keep the whole trail
+// (and its reasons) so the kernels can rewind and replay it.
+//
+// Without learning, big random instances tend to end in one enormous
+// cascade on the last level, and analysis is quadratic in that; hence the
+// modest default instance.
+struct snapshot {
+    assignment a;
+    watched_literals w;
+    glue_clauses g;
+    statistics stats;
+    vsids v;
+    vmtf m;
+    lrb b;
+    flexsize_clause p;
+    null_tracer proof;
+    std::vector<literal> trail;
+    std::vector<cnf::clause_iterator> reasons;
+    cnf::clause_iterator conflict = nullptr;
+
+    snapshot(cnf& c): a(c), w(c), g(c), v(c, stats), m(c, stats), b(c, stats), p(c) {
+        for (;;) {
+            while (w.has_units() && !conflict) {
+                literal unit; cnf::clause_iterator reason;
+                std::tie(unit, reason) = w.pop_unit();
+                if (clause_unsat(reason, a)) {
+                    conflict = reason;
+                }
+                else {
+                    a.push_implicant(unit, reason);
+                    w.apply(a, unit);
+                }
+            }
+            w.clear_units();
+            if (conflict) { break; }
+            literal d = v.get_literal(a);
+            if (!d) { break; }
+            a.push_decision(d);
+            w.apply(a, d);
+        }
+        for (int i = 0; i < a.assigned_count; ++i) {
+            trail.push_back(a.begin()[i]);
+            reasons.push_back(a.reason_at(i));
+        }
+    }
+
+    // Analysis pops the trail as it resolves, so afterwards we put the
+    // implied literals back to be ready for the next round.
+    void analyze_once() {
+        p.clear();
+        analyze_conflict(p, a, conflict, proof, v);
+        for (size_t i = a.assigned_count; i < trail.size(); ++i) {
+            ASSERT(reasons[i]);
+            a.push_implicant(trail[i], reasons[i]);
+        }
+    }
+};
+
+int main(int argc, char* argv[]) {
+    const char* file = nullptr;
+    long vars = 5000;
+    double ratio = 4.0;
+    uint64_t seed = 1;
+    int reps = 100;
+    bool renumber = false;
+    int prefetch = -1;
+    for (int i = 1; i < argc; ++i) {
+        if (!strncmp(argv[i], "--vars=", 7)) { vars = atol(argv[i] + 7); }
+        else if (!strncmp(argv[i], "--ratio=", 8)) { ratio = atof(argv[i] + 8); }
+        else if (!strncmp(argv[i], "--seed=", 7)) { seed = strtoull(argv[i] + 7, nullptr, 10); }
+        else if (!strncmp(argv[i], "--reps=", 7)) { reps = max(1, atoi(argv[i] + 7)); }
+        else if (!strcmp(argv[i], "--renumber")) { renumber = true; }
+        else if (!strncmp(argv[i], "--prefetch=", 11)) { prefetch = atoi(argv[i] + 11); }
+        else if (!strcmp(argv[i], "--huge-pages=off")) { current_memory_policy.huge_pages = memory_policy::normal; }
+        else if (!strcmp(argv[i], "--huge-pages=thp")) { current_memory_policy.huge_pages = memory_policy::transparent; }
+        else if (!strcmp(argv[i], "--huge-pages=explicit")) { current_memory_policy.huge_pages = memory_policy::explicit_huge; }
+        else if (!strncmp(argv[i], "--numa-node=", 12)) { current_memory_policy.numa_node = atoi(argv[i] + 12); }
+        else if (argv[i][0] != '-' && !file) { file = argv[i]; }
+        else {
+            cerr << "usage: " << argv[0] << " [input.cnf | --vars=N --ratio=R --seed=S] [--reps=N] [--renumber] [--prefetch=K]"
+                 << " [--huge-pages=off|thp|explicit] [--numa-node=N]" << endl;
+            return 1;
+        }
+    }
+
+    cnf c = [&]() {
+        if (file) {
+            ifstream in(file);
+            return load_cnf(cnf_reader::cnf_from_stream(in));
+        }
+        cnf_sink sink;
+        random_ksat(sink, vars, 3, ratio, seed);
+        return sink.take();
+    }();
+    if (renumber) { c = renumbering(c).apply(c); }
+
+    auto setup_start = chrono::steady_clock::now();
+    snapshot s(c);
+    cout << "instance: " << (file ? file : "random 3-SAT") << ", "
+         << c.max_literal_count / 2 << " vars, " << c.clauses_count << " clauses" << endl;
+    cout << "snapshot: " << s.trail.size() << " assigned, "
+         << s.a.curr_level() + 1 << " decisions, "
+         << (s.a.last_lit_latest_level() - s.a.first_lit_latest_level()) << " on the last level, "
+         << (s.conflict ? "conflict found" : "no conflict") << ", "
+         << chrono::duration<double>(chrono::steady_clock::now() - setup_start).count()
+         << "s to build" << endl;
+
+    perf_counters pc;
+    cout << left << setw(22) << "kernel" << right
+         << setw(12) << "ops" << setw(12) << "ns/op" << setw(12) << "cycles/op";
+    for (int i = 0; i < pc.count; ++i) { cout << setw(15) << (string(pc.names[i]) + "/op"); }
+    cout << endl;
+
+    volatile unsigned sink = 0;
+    if (s.conflict) {
+        const int level = s.a.curr_level();
+        measure("analyze_conflict", reps, pc, [&]() {
+            s.analyze_once();
+            return 1l;
+        });
+        ASSERT(s.a.curr_level() == level);
+        (void)level;
+
+        measure("calculate_lbd", reps * 100, pc, [&]() {
+            sink = s.g.calculate_lbd(s.a, s.p);
+            return 1l;
+        });
+    }
+
+    // The clauses BCP would have to look at: a watch is false.
+    std::vector<cnf::clause_iterator> scanned;
+    for (auto cit = c.clause_begin(); cit != c.clause_end(); ++cit) {
+        auto ws = s.w.watches_of(cit);
+        if (ws.w2 && (s.a.is_false(ws.w1) || s.a.is_false(ws.w2))) { scanned.push_back(cit); }
+    }
+    auto find_new_literal = [&]() {
+        unsigned x = 0;
+        for (auto cit : scanned) { x ^= s.w.find_new_literal(cit, s.a, s.w.watches_of(cit)).index(); }
+        sink = x;
+        return long(scanned.size());
+    };
+    measure("find_new_literal", reps, pc, find_new_literal);
+    if (clause_scan::use_avx2) {
+        clause_scan::use_avx2 = false;
+        measure("find_new_literal/scalar", reps, pc, find_new_literal);
+        clause_scan::use_avx2 = true;
+    }
+
+    measure("vsids::get_literal", reps, pc, [&]() {
+        sink = s.v.get_literal(s.a).index();
+        return 1l;
+    });
+    // The first call walks the queue to the cursor; after that it's where
+    // the search leaves it, as it would be.
+    measure("vmtf::get_literal", reps, pc, [&]() {
+        sink = s.m.get_literal(s.a).index();
+        return 1l;
+    });
+    // Likewise, the first call pops the assigned variables off the heap.
+    measure("lrb::get_literal", reps, pc, [&]() {
+        sink = s.b.get_literal(s.a).index();
+        return 1l;
+    });
+
+    // Rewind to the root and replay the whole trail, propagating as we go.
+    auto replay = [&]() {
+        s.a.restart();
+        long ops = 0;
+        for (size_t i = s.a.assigned_count; i < s.trail.size(); ++i) {
+            if (s.reasons[i]) { s.a.push_implicant(s.trail[i], s.reasons[i]); }
+            else { s.a.push_decision(s.trail[i]); }
+            s.w.apply(s.a, s.trail[i]);
+            ops++;
+        }
+        s.w.clear_units();
+        return ops;
+    };
+    // The first replay moves clauses off the watches it falsifies; after
+    // that the lists are at a fixpoint and every replay does the same work,
+    // so do it once here rather than in whichever measurement comes first.
+    replay();
+    if (prefetch >= 0) {
+        s.w.prefetch_distance = prefetch;
+        measure("watched_literals::apply", reps, pc, replay);
+        return 0;
+    }
+    // Without --prefetch, compare prefetching 8 ahead with none at all,
+    // alternating which goes first so neither gets the other's warm caches.
+    const int distances[2] = {8, 0};
+    for (int round = 0; round < 4; ++round) {
+        for (int j = 0; j < 2; ++j) {
+            const int k = distances[(round + j) % 2];
+            s.w.prefetch_distance = k;
+            const string name = "apply/prefetch=" + to_string(k);
+            measure(name.c_str(), reps, pc, replay);
+        }
+    }
+    return 0;
+}
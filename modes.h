@@ -0,0 +1,249 @@
+#ifndef MODES_H
+#define MODES_H
+
+#include "literal_map.h"
+#include "assignment.h"
+#include "restarts.h"
+#include "stats.h"
+#include "profiler.h"
+#include "checkpoint.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+// An exponential moving average, bias-corrected so it means something
+// from the first sample (Biere and Froehlich, "Evaluating CDCL Restart
+// Schemes").
+class moving_average {
+    const double alpha;
+    double biased = 0, beta = 1;
+
+public:
+    moving_average(double alpha): alpha(alpha) {}
+    void add(double x) {
+        biased += alpha * (x - biased);
+        beta *= 1 - alpha;
+    }
+    double value() const { return beta < 1 ? biased / (1 - beta) : 0; }
+
+    void save(checkpoint_writer& out) const {
+        out.put_double(biased);
+        out.put_double(beta);
+    }
+    void load(checkpoint_reader& in) {
+        biased = in.get_double();
+        beta = in.get_double();
+    }
+};
+
+// Alternating between two searches, as CaDiCaL does:
+//   focused: Focused decides, and we restart whenever the learned clauses'
+//     glue has been worse lately than in the long run (a fast moving
+//     average of LBD 10% over a slow one);
+//   stable: Stable decides, with luby restarts (unit 1024), and decisions
+//     take their target phase where there is one: the value in the
+//     longest conflict-free trail since the last restart.
+// Each keeps its own scores. Both hear about everything that goes on and
+// off the trail (so their queues and heaps stay right), but only the one
+// deciding hears about analysis, so only it bumps.
+//
+// Modes are measured in ticks, literals assigned: the first focused one
+// is 1000 conflicts, and after that the ticks it took set the unit. Each
+// focused/stable pair is twice as long as the last. Switching restarts.
+//
+// This is used as the heuristic, since it decides, and asks for its own
+// restarts; the restart policy alongside it is no_restarts.
+template<typename Focused, typename Stable>
+class stable_focused {
+    typedef std::chrono::steady_clock clock;
+
+    Focused focused;
+    Stable stable;
+    statistics& stats;
+    bool stable_mode = false;
+
+    // Where this mode ends.
+    long ticks = 0, unit = 0, limit = 0;
+    long conflicts = 0;
+    int switches = 0;
+    clock::time_point since = clock::now();
+
+    moving_average fast_glue{0.03}, slow_glue{1e-5};
+    long conflicts_since_restart = 0;
+    luby_restarts luby{1024};
+
+    // The target phases, from a trail of target_size literals. While
+    // deciding we only note how much of the trail is conflict-free (all of
+    // it, when we're asked for a decision); it's copied when backtracking
+    // throws away more than the target has, so once per descent rather
+    // than at every decision.
+    variable_map<signed char> target;
+    int target_size = 0;
+    int conflict_free = 0;
+    const literal* trail = nullptr;
+
+    // For the glue of each learned clause.
+    std::vector<unsigned long> level_seen;
+    unsigned long glues = 0;
+
+    int glue(const assignment& a, cnf::clause_iterator c) {
+        glues++;
+        int g = 0;
+        for (literal l : c) {
+            const int level = a.decision_level(a.is_true(l) ? l : -l) + 1;
+            if (level_seen[level] == glues) { continue; }
+            level_seen[level] = glues;
+            g++;
+        }
+        return g;
+    }
+
+    void book_time() {
+        STAT(
+            const auto now = clock::now();
+            const double t = std::chrono::duration<double>(now - since).count();
+            since = now;
+            if (stable_mode) { stats.stable_seconds += t; }
+            else { stats.focused_seconds += t; }
+        );
+    }
+
+    bool mode_over() const {
+        if (!unit) { return conflicts >= 1000; }
+        return ticks >= limit;
+    }
+
+    void switch_mode() {
+        book_time();
+        if (!unit) { unit = ticks; }
+        stable_mode = !stable_mode;
+        switches++;
+        STAT(stats.mode_switches++);
+        ticks = 0;
+        limit = unit << std::min(switches / 2, 30);
+    }
+
+    public:
+    stable_focused(const cnf& c, statistics& stats):
+        focused(c, stats),
+        stable(c, stats),
+        stats(stats),
+        target(c.max_literal_count),
+        level_seen(c.max_literal_count / 2 + 2)
+    {}
+
+    literal get_literal(const assignment& a) {
+        if (!stable_mode) { return focused.get_literal(a); }
+        conflict_free = a.assigned_count;
+        trail = a.begin();
+        literal l = stable.get_literal(a);
+        if (l && target[l.var()]) {
+            l = literal::positive(l.var());
+            if (target[l.var()] < 0) { l = -l; }
+        }
+        return l;
+    }
+
+    void set_phase(literal l) {
+        focused.set_phase(l);
+        stable.set_phase(l);
+    }
+
+    void assigned(literal l) {
+        ticks++;
+        focused.assigned(l);
+        stable.assigned(l);
+    }
+
+    void analyzed(cnf::clause_iterator reason) {
+        if (stable_mode) { stable.analyzed(reason); }
+        else { focused.analyzed(reason); }
+    }
+
+    void learned(const assignment& a, cnf::clause_iterator c) {
+        conflicts++;
+        conflicts_since_restart++;
+        if (stable_mode) {
+            STAT(stats.stable_conflicts++);
+            stable.learned(a, c);
+            luby.on_conflict();
+        }
+        else {
+            STAT(stats.focused_conflicts++);
+            focused.learned(a, c);
+            const int g = glue(a, c);
+            fast_glue.add(g);
+            slow_glue.add(g);
+        }
+    }
+
+    void unassigned(const literal* b, const literal* e) {
+        if (conflict_free > target_size) {
+            target_size = conflict_free;
+            for (int i = 0; i < conflict_free; ++i) {
+                target[trail[i].var()] = trail[i].is_negative() ? -1 : 1;
+            }
+        }
+        conflict_free = 0;
+        focused.unassigned(b, e);
+        stable.unassigned(b, e);
+    }
+
+    bool should_restart() {
+        bool restart;
+        if (mode_over()) {
+            switch_mode();
+            restart = true;
+        }
+        else if (stable_mode) {
+            restart = luby.should_restart();
+        }
+        else {
+            restart = conflicts_since_restart >= 2 &&
+                      fast_glue.value() > 1.1 * slow_glue.value();
+        }
+        if (restart) {
+            conflicts_since_restart = 0;
+            target_size = conflict_free = 0;
+        }
+        return restart;
+    }
+
+    // For checkpoint.h: which mode we're in and how far along, the restart
+    // state of each, and then each side's own. Target phases aren't kept,
+    // since we load at the root, where they're forgotten anyway.
+    void save(checkpoint_writer& out) const {
+        out.put_number(stable_mode);
+        out.put_number(ticks);
+        out.put_number(unit);
+        out.put_number(limit);
+        out.put_number(conflicts);
+        out.put_number(switches);
+        out.put_number(conflicts_since_restart);
+        fast_glue.save(out);
+        slow_glue.save(out);
+        luby.save(out);
+        focused.save(out);
+        stable.save(out);
+    }
+    void load(checkpoint_reader& in) {
+        stable_mode = in.get_number();
+        ticks = in.get_number();
+        unit = in.get_number();
+        limit = in.get_number();
+        conflicts = in.get_number();
+        switches = in.get_number();
+        conflicts_since_restart = in.get_number();
+        fast_glue.load(in);
+        slow_glue.load(in);
+        luby.load(in);
+        focused.load(in);
+        stable.load(in);
+    }
+
+    // The time since the last switch goes to whichever mode we finished in.
+    ~stable_focused() { book_time(); }
+};
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef PAGE_ALLOC_H
+#define PAGE_ALLOC_H
+
+#include <memory>
+#include <new>
+#include <cstdlib>
+#include <cstddef>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/mempolicy.h>
+#endif
+
+// Where the big tables (the clause arena, clause_maps, literal_maps, and
+// so the watch lists' headers) get their memory. Once an instance gets
+// large, apply() spends a lot of its time on TLB misses and, on a
+// multi-socket machine, on memory that lives on the other node. So arrays
+// of at least huge_page_size are mmapped on their own and either
+// madvised for transparent huge pages or taken from the explicit
+// (hugetlbfs) pool, and can be bound to a NUMA node. Small arrays, and
+// anything where the kernel says no, just go to operator new.
+struct memory_policy {
+    enum pages { normal, transparent, explicit_huge };
+    pages huge_pages = transparent;
+    // Preferred NUMA node for big arrays, -1 to leave it to first touch
+    // (which, for a solver running on its own thread, is its own node).
+    int numa_node = -1;
+};
+
+// Per thread, so each solver thread can say where its tables go before
+// building them.
+thread_local memory_policy current_memory_policy;
+
+const size_t huge_page_size = 2 << 20;
+
+namespace page_alloc {
+    // How we got a block; we need to know how to give it back.
+    enum source { heap, mapped };
+
+    size_t round_up(size_t bytes) {
+        return (bytes + huge_page_size - 1) & ~(huge_page_size - 1);
+    }
+
+    void* map(size_t bytes, source& from) {
+        const memory_policy& policy = current_memory_policy;
+        from = heap;
+#ifdef __linux__
+        if (policy.huge_pages == memory_policy::normal || bytes < huge_page_size) {
+            return ::operator new(bytes);
+        }
+        const size_t length = round_up(bytes);
+        void* p = MAP_FAILED;
+#ifdef MAP_HUGETLB
+        if (policy.huge_pages == memory_policy::explicit_huge) {
+            p = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        }
+#endif
+        if (p == MAP_FAILED) {
+            // No hugetlbfs pages reserved (or we weren't asked): ordinary
+            // pages, which khugepaged can promote.
+            p = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED) { return ::operator new(bytes); }
+#ifdef MADV_HUGEPAGE
+            madvise(p, length, MADV_HUGEPAGE);
+#endif
+        }
+        if (policy.numa_node >= 0 && policy.numa_node < 64) {
+            // Preferred rather than bound, so a full node spills over
+            // instead of failing; if there's no such node this is a no-op.
+            unsigned long mask = 1ul << policy.numa_node;
+            syscall(SYS_mbind, p, length, MPOL_PREFERRED, &mask, 64, 0);
+        }
+        from = mapped;
+        return p;
+#else
+        (void)policy;
+        return ::operator new(bytes);
+#endif
+    }
+
+    void unmap(void* p, size_t bytes, source from) {
+#ifdef __linux__
+        if (from == mapped) {
+            munmap(p, round_up(bytes));
+            return;
+        }
+#endif
+        (void)bytes;
+        (void)from;
+        ::operator delete(p);
+    }
+}
+
+// Destroys and frees what make_big_array made.
+template<typename T>
+struct big_array_deleter {
+    size_t count = 0;
+    page_alloc::source from = page_alloc::heap;
+
+    void operator()(T* p) const {
+        for (size_t i = 0; i < count; ++i) { p[i].~T(); }
+        page_alloc::unmap(p, count * sizeof(T), from);
+    }
+};
+
+template<typename T>
+using big_array = std::unique_ptr<T[], big_array_deleter<T>>;
+
+// Like make_unique<T[]>(n): n value-initialized Ts, but allocated under
+// current_memory_policy.
+template<typename T>
+big_array<T> make_big_array(size_t n) {
+    big_array_deleter<T> d;
+    d.count = n;
+    T* p = static_cast<T*>(page_alloc::map(n * sizeof(T) + !n, d.from));
+    for (size_t i = 0; i < n; ++i) { new (p + i) T(); }
+    return big_array<T>(p, d);
+}
+
+#endif
@@ -0,0 +1,243 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// Where does the time in solve() go? Build with -D PROFILE_ON and wrap the
+// interesting regions in PROFILE_SCOPE(phase). Scopes nest, so we report
+// both inclusive and exclusive time per phase, plus the whole call tree as
+// folded stacks (one "solve;bcp;watch_apply 1234" line per path) that
+// flamegraph.pl understands directly.
+//
+// Without PROFILE_ON every macro here expands to nothing.
+
+#ifdef PROFILE_ON
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+enum profile_phase {
+    phase_solve,
+    phase_bcp,
+    phase_watch_apply,
+    phase_analyze,
+    phase_lbd,
+    phase_reduce,
+    phase_remap,
+    phase_decide,
+    phase_local_search,
+    phase_xor,
+    phase_count
+};
+
+const char* phase_name(profile_phase p) {
+    static const char* names[phase_count] = {
+        "solve", "bcp", "watch_apply", "analyze", "lbd", "reduce", "remap", "decide", "local_search", "xor"
+    };
+    return names[p];
+}
+
+// Power-of-two buckets: bucket i counts values in [2^(i-1), 2^i).
+struct log_histogram {
+    static const int buckets = 32;
+    long counts[buckets] = {0};
+
+    void add(unsigned long x) {
+        int b = 0;
+        while (x && b < buckets - 1) {
+            x >>= 1;
+            b++;
+        }
+        counts[b]++;
+    }
+    void merge(const log_histogram& other) {
+        for (int i = 0; i < buckets; ++i) { counts[i] += other.counts[i]; }
+    }
+
+    void print(std::ostream& o, const char* title) const {
+        o << "c " << title << std::endl;
+        long total = 0;
+        for (long c : counts) { total += c; }
+        for (int i = 0; i < buckets; ++i) {
+            if (!counts[i]) { continue; }
+            long lo = i ? (1l << (i - 1)) : 0;
+            long hi = i ? (1l << i) - 1 : 0;
+            o << "c   " << std::setw(8) << lo << " - " << std::setw(8) << hi
+              << std::setw(14) << counts[i]
+              << std::setw(8) << std::fixed << std::setprecision(1)
+              << (100.0 * counts[i] / total) << "%" << std::endl;
+        }
+    }
+};
+
+class profiler {
+    typedef unsigned long long ticks;
+
+    static ticks now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    // One node per distinct stack of phases.
+    struct node {
+        profile_phase phase;
+        node* parent;
+        ticks inclusive = 0;
+        long calls = 0;
+        std::unique_ptr<node> children[phase_count];
+        node(profile_phase phase, node* parent): phase(phase), parent(parent) {}
+
+        ticks exclusive() const {
+            ticks t = inclusive;
+            for (auto& c : children) {
+                if (c) { t -= c->inclusive; }
+            }
+            return t;
+        }
+    };
+
+    node root{phase_solve, nullptr};
+    node* current = &root;
+
+    ticks start_ticks = now();
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+    double seconds_per_tick() const {
+        double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start_time).count();
+        ticks elapsed = now() - start_ticks;
+        return elapsed ? seconds / elapsed : 0;
+    }
+
+    void totals(const node& n, ticks* inclusive, ticks* exclusive, long* calls,
+                bool* active) const {
+        for (auto& c : n.children) {
+            if (!c) { continue; }
+            // Only count the outermost instance of a phase towards its
+            // inclusive time, so recursion doesn't double count.
+            if (!active[c->phase]) { inclusive[c->phase] += c->inclusive; }
+            exclusive[c->phase] += c->exclusive();
+            calls[c->phase] += c->calls;
+            bool was_active = active[c->phase];
+            active[c->phase] = true;
+            totals(*c, inclusive, exclusive, calls, active);
+            active[c->phase] = was_active;
+        }
+    }
+
+    static void merge(node& into, const node& from) {
+        into.inclusive += from.inclusive;
+        into.calls += from.calls;
+        for (auto& c : from.children) {
+            if (!c) { continue; }
+            auto& mine = into.children[c->phase];
+            if (!mine) { mine = std::make_unique<node>(c->phase, &into); }
+            merge(*mine, *c);
+        }
+    }
+
+    void fold(const node& n, const std::string& prefix, std::ostream& o, double scale) const {
+        for (auto& c : n.children) {
+            if (!c) { continue; }
+            std::string path = prefix.empty() ? phase_name(c->phase)
+                                              : prefix + ";" + phase_name(c->phase);
+            long us = static_cast<long>(c->exclusive() * scale * 1e6);
+            if (us > 0) { o << path << " " << us << std::endl; }
+            fold(*c, path, o, scale);
+        }
+    }
+
+public:
+    log_histogram watch_list_lengths;
+    log_histogram clause_sizes;
+
+    // One per thread (each component solver has its own). Worker threads
+    // merge theirs into the main thread's as they finish, so the report
+    // covers them all; times are then summed over threads, and can add up
+    // to more than the run took.
+    static profiler& instance() {
+        static thread_local profiler p;
+        return p;
+    }
+
+    void merge(const profiler& other) {
+        merge(root, other.root);
+        watch_list_lengths.merge(other.watch_list_lengths);
+        clause_sizes.merge(other.clause_sizes);
+    }
+
+    ticks enter(profile_phase p) {
+        auto& child = current->children[p];
+        if (!child) { child = std::make_unique<node>(p, current); }
+        current = child.get();
+        current->calls++;
+        return now();
+    }
+    void leave(ticks started) {
+        current->inclusive += now() - started;
+        current = current->parent;
+    }
+
+    void print_report(std::ostream& o) const {
+        ticks inclusive[phase_count] = {0};
+        ticks exclusive[phase_count] = {0};
+        long calls[phase_count] = {0};
+        bool active[phase_count] = {false};
+        totals(root, inclusive, exclusive, calls, active);
+        const double scale = seconds_per_tick();
+
+        o << "c " << std::left << std::setw(14) << "phase" << std::right
+          << std::setw(14) << "calls"
+          << std::setw(14) << "inclusive s"
+          << std::setw(14) << "exclusive s"
+          << std::setw(14) << "ns/call" << std::endl;
+        for (int p = 0; p < phase_count; ++p) {
+            if (!calls[p]) { continue; }
+            o << "c " << std::left << std::setw(14) << phase_name(profile_phase(p)) << std::right
+              << std::setw(14) << calls[p]
+              << std::setw(14) << std::fixed << std::setprecision(3) << inclusive[p] * scale
+              << std::setw(14) << exclusive[p] * scale
+              << std::setw(14) << std::setprecision(0) << (inclusive[p] * scale * 1e9 / calls[p])
+              << std::endl;
+        }
+        watch_list_lengths.print(o, "watch list lengths visited:");
+        clause_sizes.print(o, "clause sizes inspected:");
+    }
+
+    // Exclusive microseconds per stack, for flamegraph.pl.
+    void print_folded(std::ostream& o) const {
+        fold(root, "", o, seconds_per_tick());
+    }
+};
+
+class scoped_timer {
+    unsigned long long started;
+public:
+    scoped_timer(profile_phase p): started(profiler::instance().enter(p)) {}
+    ~scoped_timer() { profiler::instance().leave(started); }
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(phase) scoped_timer PROFILE_CONCAT(profile_scope_, __LINE__)(phase)
+#define PROFILE_SAMPLE(histogram, x) profiler::instance().histogram.add(x)
+#define PROFSTMT(x) x
+
+#else
+
+#define PROFILE_SCOPE(phase)
+#define PROFILE_SAMPLE(histogram, x)
+#define PROFSTMT(x)
+
+#endif
+
+#endif
@@ -0,0 +1,242 @@
+#ifndef PROOF_H
+#define PROOF_H
+
+#include "debug.h"
+#include "cnf.h"
+#include "clause_map.h"
+#include "assignment.h"
+#include "stamped_set.h"
+
+#include <cstdio>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// A double-buffered byte sink. The solver fills the front buffer; when it's
+// full we hand it to a background thread that fwrite()s it while we keep
+// filling the other one. The search only waits if the disk falls a whole
+// buffer behind.
+class async_writer {
+    FILE* out;
+    const size_t capacity;
+    std::unique_ptr<char[]> front;
+    std::unique_ptr<char[]> back;
+    size_t front_count = 0;
+    size_t back_count = 0;
+    bool back_pending = false;
+    bool done = false;
+
+    std::mutex m;
+    std::condition_variable cv;
+    std::thread worker;
+
+    void run() {
+        std::unique_lock<std::mutex> lock(m);
+        for (;;) {
+            cv.wait(lock, [&]() { return back_pending || done; });
+            if (back_pending) {
+                // The solver won't touch the back buffer until we clear
+                // back_pending, so we can write without holding the lock.
+                lock.unlock();
+                fwrite(back.get(), 1, back_count, out);
+                lock.lock();
+                back_pending = false;
+                cv.notify_all();
+            }
+            else if (done) {
+                return;
+            }
+        }
+    }
+
+    void hand_off() {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&]() { return !back_pending; });
+        std::swap(front, back);
+        back_count = front_count;
+        front_count = 0;
+        back_pending = true;
+        cv.notify_all();
+    }
+
+public:
+    async_writer(FILE* out, size_t capacity = 1 << 22):
+        out(out),
+        capacity(capacity),
+        front(std::make_unique<char[]>(capacity)),
+        back(std::make_unique<char[]>(capacity)),
+        worker(&async_writer::run, this)
+    {}
+
+    ~async_writer() {
+        if (front_count) { hand_off(); }
+        {
+            std::unique_lock<std::mutex> lock(m);
+            cv.wait(lock, [&]() { return !back_pending; });
+            done = true;
+            cv.notify_all();
+        }
+        worker.join();
+        fflush(out);
+    }
+
+    void put(char c) {
+        if (front_count == capacity) { hand_off(); }
+        front[front_count++] = c;
+    }
+
+    // The variable-length encoding of binary DRAT: 7 bits at a time,
+    // least significant first, with the high bit meaning "more to come".
+    void put_number(unsigned long x) {
+        while (x > 127) {
+            put(static_cast<char>((x & 127) | 128));
+            x >>= 7;
+        }
+        put(static_cast<char>(x));
+    }
+
+    // Both literals and (for LRAT) clause ids are mapped 2*|x| + (x<0).
+    void put_signed(long x) {
+        put_number(x < 0 ? (2ul * -x) + 1 : 2ul * x);
+    }
+};
+
+// Records clause additions and deletions as a binary DRAT proof, or as
+// binary LRAT if we're also given the antecedents of each lemma.
+// Every lemma we learn is RUP, so LRAT hints are just the reasons we
+// resolved against (in trail order) followed by the conflict clause.
+class proof_tracer {
+public:
+    enum format { drat, lrat };
+
+private:
+    async_writer out;
+    const format fmt;
+    const int literal_count;
+    clause_map<long> ids;
+    long next_id = 1;
+    long lemma_id = 0;
+
+    template<typename C>
+    void put_literals(const C& c) {
+        for (literal l : c) { out.put_signed(l.to_dimacs()); }
+        out.put_number(0);
+    }
+
+public:
+    // The antecedents of the lemma currently being derived.
+    std::vector<cnf::clause_iterator> hints;
+
+    proof_tracer(cnf& c, FILE* f, format fmt):
+        out(f),
+        fmt(fmt),
+        literal_count(c.max_literal_count),
+        ids(c, c.clauses_max, c.clauses.get())
+    {
+        // The input clauses are implicitly numbered 1..n, in file order.
+        for (auto cit = c.clause_begin(); cit != c.clause_end(); ++cit) {
+            ids[cit] = next_id++;
+        }
+    }
+
+    bool wants_hints() const { return fmt == lrat; }
+
+    // Called with each reason clause as conflict analysis resolves it away.
+    void resolved(cnf::clause_iterator reason) {
+        if (wants_hints()) { hints.push_back(reason); }
+    }
+
+    // Emit the lemma we just derived from conflict. This has to happen
+    // before any reduction: the clauses it was derived from (and the
+    // hints that name them) may not survive it.
+    template<typename C>
+    void add_clause(const C& lemma, cnf::clause_iterator conflict) {
+        lemma_id = next_id++;
+        out.put('a');
+        if (fmt == lrat) { out.put_signed(lemma_id); }
+        put_literals(lemma);
+        if (fmt == lrat) {
+            // we resolved from the top of the trail down, so reverse to
+            // get the order in which they become unit.
+            std::for_each(hints.rbegin(), hints.rend(), [&](cnf::clause_iterator h) {
+                out.put_signed(ids[h]);
+            });
+            out.put_signed(ids[conflict]);
+            out.put_number(0);
+        }
+        hints.clear();
+    }
+
+    // ...and once it has a home in the cnf, remember its id.
+    void inserted(cnf::clause_iterator cit) { ids[cit] = lemma_id; }
+
+    // The conflict happened with nothing decided, so the empty clause
+    // follows from the level-0 trail alone.
+    void add_empty_clause(const assignment& a, cnf::clause_iterator conflict) {
+        out.put('a');
+        if (fmt == drat) {
+            out.put_number(0);
+            return;
+        }
+        out.put_signed(next_id++);
+        out.put_number(0);
+
+        // Walk the trail backwards collecting just the reasons we need.
+        literal_bitset needed(literal_count);
+        for (literal l : conflict) { needed.insert(-l); }
+        hints.clear();
+        for (int i = a.assigned_count - 1; i >= 0; --i) {
+            literal l = a.begin()[i];
+            if (!needed.contains(l)) { continue; }
+            auto reason = a.reason_at(i);
+            ASSERT(reason);
+            hints.push_back(reason);
+            for (literal r : reason) {
+                if (r != l) { needed.insert(-r); }
+            }
+        }
+        std::for_each(hints.rbegin(), hints.rend(), [&](cnf::clause_iterator h) {
+            out.put_signed(ids[h]);
+        });
+        out.put_signed(ids[conflict]);
+        out.put_number(0);
+        hints.clear();
+    }
+
+    // Called *before* the cnf compacts itself: m[i] == -1 means clause i
+    // is about to go away.
+    void delete_clauses(const cnf& c, const int* m) {
+        if (fmt == lrat) {
+            bool any = false;
+            for (auto cit = c.clause_begin(); cit != c.clause_end(); ++cit) {
+                if (m[cit - c.clause_begin()] != -1) { continue; }
+                if (!any) {
+                    out.put('d');
+                    any = true;
+                }
+                out.put_signed(ids[cit]);
+            }
+            if (any) { out.put_number(0); }
+            return;
+        }
+        for (auto cit = c.clause_begin(); cit != c.clause_end(); ++cit) {
+            if (m[cit - c.clause_begin()] != -1) { continue; }
+            out.put('d');
+            put_literals(cit);
+        }
+    }
+};
+
+// Stands in for proof_tracer when we aren't writing a proof, so a solver
+// instantiated with it has no proof code left in it at all.
+struct null_tracer {
+    void resolved(cnf::clause_iterator) {}
+    template<typename C>
+    void add_clause(const C&, cnf::clause_iterator) {}
+    void inserted(cnf::clause_iterator) {}
+    void add_empty_clause(const assignment&, cnf::clause_iterator) {}
+    void delete_clauses(const cnf&, const int*) {}
+};
+
+#endif
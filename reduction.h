@@ -0,0 +1,74 @@
+#ifndef REDUCTION_H
+#define REDUCTION_H
+
+#include "cnf.h"
+#include "assignment.h"
+#include "glue_clauses.h"
+#include "stats.h"
+#include "checkpoint.h"
+
+// Clause database reduction policies. The solver asks for a score of each
+// learned clause while it's still falsified (before backjumping), gives
+// the policy a chance to shrink the database before the clause goes in,
+// and then tells it where the clause landed.
+
+// Keep the half of the clauses with the best LBD whenever the database
+// outgrows a (geometrically increasing) limit.
+class glue_reduction {
+    glue_clauses g;
+public:
+    glue_reduction(cnf& c): g(c) {}
+
+    template<typename C>
+    int score(const assignment& a, const C& cl) { return g.calculate_lbd(a, cl); }
+
+    template<typename Tracer>
+    void maybe_reduce(cnf& c, const assignment& a, Tracer& proof, statistics& stats) {
+        if (g.current_clause_count > c.clauses_count) { return; }
+        int n = 0;
+        auto m = g.generate_mapping(c, a, n);
+        STAT(stats.reductions++);
+        STAT(stats.deleted_clauses += c.clauses_count - n);
+        proof.delete_clauses(c, m.get());
+        c.remap_clauses(m.get(), n);
+        g.current_clause_count *= 1.3;
+    }
+
+    void learned(cnf::clause_iterator cit, int score) { g.lbd[cit] = score; }
+    // 0 for the clauses we have to keep.
+    int lbd(cnf::clause_iterator cit) { return g.lbd[cit]; }
+
+    // For checkpoint.h: the limit, and each clause's LBD (0 for the ones
+    // we have to keep) in c's order. There may be clauses after those, the
+    // root units; they get 0.
+    void save(checkpoint_writer& out, const cnf& c) {
+        out.put_number(g.current_clause_count);
+        out.put_number(c.clauses_count);
+        for (auto cit = c.clause_begin(); cit != c.clause_end(); ++cit) { out.put_number(g.lbd[cit]); }
+    }
+    void load(checkpoint_reader& in, const cnf& c) {
+        g.current_clause_count = in.get_number();
+        const unsigned long n = in.get_count();
+        if (n > (unsigned long)c.clauses_count) {
+            in.ok = false;
+            return;
+        }
+        for (auto cit = c.clause_begin(); cit != c.clause_begin() + n; ++cit) { g.lbd[cit] = in.get_number(); }
+    }
+};
+
+// Never delete anything. Mostly useful as a baseline.
+struct keep_all {
+    keep_all(cnf&) {}
+    template<typename C>
+    int score(const assignment&, const C&) { return 0; }
+    template<typename Tracer>
+    void maybe_reduce(cnf&, const assignment&, Tracer&, statistics&) {}
+    void learned(cnf::clause_iterator, int) {}
+    // We don't know which clauses are learned, so nothing gets exported.
+    int lbd(cnf::clause_iterator) { return 0; }
+    void save(checkpoint_writer&, const cnf&) const {}
+    void load(checkpoint_reader&, const cnf&) {}
+};
+
+#endif
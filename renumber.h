@@ -0,0 +1,113 @@
+#ifndef RENUMBER_H
+#define RENUMBER_H
+
+#include "cnf.h"
+
+#include <vector>
+#include <algorithm>
+
+// Inputs come with whatever variable numbering their generator used, so a
+// clause's literals (and the watch lists and literal_map slots they touch)
+// can be scattered all over memory. This renames the variables in
+// Cuthill-McKee order over the variable-clause graph: a BFS from a
+// low-degree variable, taking each newly reached batch of neighbours in
+// order of increasing degree. Variables that share clauses end up with
+// nearby numbers, and we rebuild the clause arena sorted by each clause's
+// smallest new variable so clauses that are visited together sit
+// together too.
+//
+// The model is mapped back with to_old().
+class renumbering {
+public:
+    // new_var[v] is what variable v is called after renumbering, and
+    // old_var inverts it. Index 0 is unused.
+    std::vector<int> new_var, old_var;
+
+    renumbering(const cnf& c) {
+        const int n = c.max_literal_count / 2;
+        const int clause_count = c.clauses_count;
+
+        // The occurrence lists, in one array (CSR style).
+        std::vector<int> degree(n + 1, 0);
+        for (auto cit = c.clause_begin(); cit != c.clause_end(); ++cit) {
+            for (literal l : cit) { degree[l.var()]++; }
+        }
+        std::vector<int> occ_start(n + 2, 0);
+        for (int v = 1; v <= n; ++v) { occ_start[v + 1] = occ_start[v] + degree[v]; }
+        std::vector<int> occ(occ_start[n + 1]);
+        std::vector<int> fill(occ_start.begin(), occ_start.end() - 1);
+        for (int ci = 0; ci < clause_count; ++ci) {
+            for (literal l : c.clause_begin() + ci) { occ[fill[l.var()]++] = ci; }
+        }
+
+        auto by_degree = [&](int u, int v) {
+            return degree[u] < degree[v] || (degree[u] == degree[v] && u < v);
+        };
+        std::vector<int> starts;
+        for (int v = 1; v <= n; ++v) { starts.push_back(v); }
+        std::sort(starts.begin(), starts.end(), by_degree);
+
+        // Each clause is expanded only once, so this is linear in the size
+        // of the formula (plus the sorting).
+        std::vector<char> seen(n + 1, 0), expanded(clause_count, 0);
+        old_var.reserve(n + 1);
+        old_var.push_back(0);
+        for (int start : starts) {
+            if (seen[start]) { continue; }
+            seen[start] = 1;
+            size_t head = old_var.size();
+            old_var.push_back(start);
+            while (head < old_var.size()) {
+                int v = old_var[head++];
+                size_t batch = old_var.size();
+                for (int i = occ_start[v]; i < occ_start[v + 1]; ++i) {
+                    int ci = occ[i];
+                    if (expanded[ci]) { continue; }
+                    expanded[ci] = 1;
+                    for (literal l : c.clause_begin() + ci) {
+                        if (seen[l.var()]) { continue; }
+                        seen[l.var()] = 1;
+                        old_var.push_back(l.var());
+                    }
+                }
+                std::sort(old_var.begin() + batch, old_var.end(), by_degree);
+            }
+        }
+
+        new_var.assign(n + 1, 0);
+        for (int i = 1; i <= n; ++i) { new_var[old_var[i]] = i; }
+    }
+
+    literal to_new(literal l) const {
+        literal p = literal::positive(new_var[l.var()]);
+        return l.is_negative() ? -p : p;
+    }
+    literal to_old(literal l) const {
+        literal p = literal::positive(old_var[l.var()]);
+        return l.is_negative() ? -p : p;
+    }
+
+    // A copy of c under the new names, with the clauses in order of their
+    // smallest (new) variable.
+    cnf apply(const cnf& c) const {
+        std::vector<std::pair<int, int>> order; // (smallest new var, clause index)
+        order.reserve(c.clauses_count);
+        for (auto cit = c.clause_begin(); cit != c.clause_end(); ++cit) {
+            int smallest = new_var.size();
+            for (literal l : cit) { smallest = std::min(smallest, new_var[l.var()]); }
+            order.push_back({smallest, int(cit - c.clause_begin())});
+        }
+        std::stable_sort(order.begin(), order.end());
+
+        cnf result(c.raw_data_max, c.clauses_max, c.max_literal_count);
+        std::vector<literal> lits;
+        for (auto o : order) {
+            lits.clear();
+            for (literal l : c.clause_begin() + o.second) { lits.push_back(to_new(l)); }
+            result.insert_clause(lits);
+        }
+        return result;
+    }
+};
+
+#endif
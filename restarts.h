@@ -0,0 +1,58 @@
+#ifndef RESTARTS_H
+#define RESTARTS_H
+
+#include "checkpoint.h"
+
+// Restart policies. The solver tells the policy about every conflict,
+// and asks it before each decision whether to go back to the root.
+
+// What we've always done: never restart.
+struct no_restarts {
+    void on_conflict() {}
+    bool should_restart() { return false; }
+    void save(checkpoint_writer&) const {}
+    void load(checkpoint_reader&) {}
+};
+
+// Restart after unit * luby(i) conflicts, where luby is the sequence
+// 1 1 2 1 1 2 4 1 1 2 1 1 2 4 8 ...
+class luby_restarts {
+    const long unit;
+    long index = 1;
+    long conflicts = 0;
+    long limit;
+
+    static long luby(long i) {
+        for (;;) {
+            long k = 1;
+            while ((1l << k) - 1 < i) { k++; }
+            if (i == (1l << k) - 1) { return 1l << (k - 1); }
+            i -= (1l << (k - 1)) - 1;
+        }
+    }
+
+public:
+    luby_restarts(long unit = 512): unit(unit), limit(unit * luby(1)) {}
+
+    void on_conflict() { conflicts++; }
+    bool should_restart() {
+        if (conflicts < limit) { return false; }
+        conflicts = 0;
+        limit = unit * luby(++index);
+        return true;
+    }
+
+    // For checkpoint.h: where we are in the sequence.
+    void save(checkpoint_writer& out) const {
+        out.put_number(index);
+        out.put_number(conflicts);
+        out.put_number(limit);
+    }
+    void load(checkpoint_reader& in) {
+        index = in.get_number();
+        conflicts = in.get_number();
+        limit = in.get_number();
+    }
+};
+
+#endif
@@ -1,289 +1,384 @@
-#include "cnf.h"
-#include "assignment.h"
-#include "watched_literals.h"
-#include "glue_clauses.h"
-#include "vsids.h"
+#include "solver.h"
+#include "dimacs.h"
+#include "renumber.h"
+#include "blocked.h"
+#include "components.h"
+#include "cube.h"
+#include "generators.h"
 
 #include <iostream>
-#include <sstream>
-#include <iterator>
 #include <vector>
+#include <cstring>
+#include <fstream>
+#include <cstdlib>
+#include <csignal>
 
-literal has_uip(flexsize_clause& p, assignment& a) {
-    int hitcount = 0;
-    literal r = 0;
-    // we increment by 1 because we ignore the actual decision level.
-    std::for_each(a.first_lit_latest_level(),
-                  a.last_lit_latest_level(),
-                  [&](literal l) {
-        if (p.contains(-l)) {
-            r = l;
-            hitcount++;
-        }
-    });
-    ASSERT(hitcount > 0);
-    if (hitcount == 1) { return r; }
-    TRACE("Not a uip!", p, "\n");
-    return 0;
-}
-
-bool solve(cnf& c) {
-    // Create all the helper data structures.
-    assignment         a(c);
-    watched_literals   w(c);
-    glue_clauses       g(c);
-    vsids              v(c);
-
-    flexsize_clause    p(c);
-
-    int conflict_counter = 0;
-
-    for (;;) {
-        p.clear();
-        TRACE("main loop start\n");
-
-
-        ASSERT(c.sanity_check());
-        ASSERT(a.sanity_check());
-        ASSERT(w.sanity_check());
-        TRACE(a, "\n", c, "\n");
+using namespace std;
 
-        ASSERT(has_conflict(c, a) == end(c));
+// The model as "v" lines. Variables the search never had to assign are
+// reported true.
+void print_model(ostream& o, const vector<literal>& model, int variables) {
+    vector<literal> value(variables + 1);
+    for (literal l : model) { value[l.var()] = l; }
+    o << "v";
+    for (int v = 1; v <= variables; ++v) {
+        o << " " << (value[v] ? value[v] : literal::positive(v));
+        if (v % 10 == 0 && v < variables) { o << "\nv"; }
+    }
+    o << " 0" << endl;
+}
 
-        // We start out with BCP. This covers degenerate inputs,
-        // and leads to a cleaner induction loop.
-        // This means that upon backtracking, we have to promise that we've
-        // already computed the units.
-        cnf::clause_iterator conflict_clause = nullptr;// has_conflict(c, a);
-        TRACE("BCP: start\n");
+// Set on SIGTERM while we're taking snapshots: the search takes one more
+// and stops.
+std::atomic<bool> terminating{false};
+extern "C" void on_sigterm(int) { terminating = true; }
 
-        while (w.has_units()) {
-            literal unit; cnf::clause_iterator reason;
-            std::tie(unit, reason) = w.pop_unit();
-            TRACE("BCP: unit = ", unit, ", reason = ", reason, "\n");
-            if (clause_unsat(reason, a)) {
-                TRACE("BCP: reason is conflict, breaking.\n");
-                conflict_clause = reason;
-                w.clear_units();
-                break;
-            }
-            else {
-                TRACE("BCP: pushing implicant ", unit, " -> ", reason, "\n");
-                ASSERT(unit == clause_implies(reason, a));
-                a.push_implicant(unit, reason);
-                w.apply(a, unit);
-            }
+int main(int argc, char* argv[]) {
+    const char* proof_file = nullptr;
+    proof_tracer::format proof_format = proof_tracer::drat;
+    bool print_stats = false;
+    const char* json_file = nullptr;
+    const char* profile_file = nullptr;
+    const configuration* config = &configurations[0];
+    bool chose_config = false;
+    bool renumber = false;
+    bool eliminate_blocked = false, eliminate_covered = false;
+    bool split = false, redecompose = false;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    bool show_model = false;
+    const char* input_file = nullptr;
+    const char* cube_file = nullptr;
+    const char* reduced_file = nullptr;
+    const char* map_file = nullptr;
+    const char* checkpoint_file = nullptr;
+    double checkpoint_interval = 300;
+    const char* resume_file = nullptr;
+    const char* export_file = nullptr;
+    int export_lbd = 6, export_size = 30;
+    const char* import_file = nullptr;
+    bool import_unchecked = false;
+    statistics stats;
+    for (int i = 1; i < argc; ++i) {
+        if (!strncmp(argv[i], "--proof=", 8)) { proof_file = argv[i] + 8; }
+        else if (!strcmp(argv[i], "--lrat")) { proof_format = proof_tracer::lrat; }
+        else if (!strcmp(argv[i], "--stats")) {
+            print_stats = true;
+            if (stats.progress_interval <= 0) { stats.progress_interval = 1; }
         }
-        TRACE("BCP: done\n");
-
-        // If there's a conflict, we'll learn from that
-        // and continue.
-        if (conflict_clause) {
-            if (a.curr_level() == -1) { return false; }
-
-            // trace backwards to make p a UIP.
-            p.adopt(conflict_clause); // a helper class with easier resolution.
-
-            DBGSTMT(const int old_level = a.curr_level());
-            // backtrack until there's only one literal from our decision
-            // level left.
-            while (!has_uip(p, a)) {
-                DBGSTMT(if (!a.curr_lit_is_implied()) {
-                    std::cout << p << std::endl << a << std::endl;
-                });
-                ASSERT(a.curr_lit_is_implied());
-                // we have to resolve against our reasons
-                if (p.contains(-a.curr_lit())) {
-                    auto unit = a.curr_lit();
-                    auto reason = a.curr_reason();
-                    p.resolve(reason, -unit);
-                    TRACE("Resolved p: ", p, "\n");
+        else if (!strncmp(argv[i], "--progress=", 11)) { stats.progress_interval = atof(argv[i] + 11); }
+        else if (!strncmp(argv[i], "--stats-json=", 13)) { json_file = argv[i] + 13; }
+        else if (!strncmp(argv[i], "--profile=", 10)) { profile_file = argv[i] + 10; }
+        else if (!strcmp(argv[i], "--renumber")) { renumber = true; }
+        else if (!strcmp(argv[i], "--bce")) { eliminate_blocked = true; }
+        else if (!strcmp(argv[i], "--cce")) { eliminate_blocked = eliminate_covered = true; }
+        else if (!strcmp(argv[i], "--components")) { split = true; }
+        else if (!strcmp(argv[i], "--redecompose")) { split = redecompose = true; }
+        else if (!strncmp(argv[i], "--threads=", 10)) { threads = std::max(1, atoi(argv[i] + 10)); }
+        else if (!strcmp(argv[i], "--model")) { show_model = true; }
+        else if (!strncmp(argv[i], "--cube=", 7)) { cube_file = argv[i] + 7; }
+        else if (!strncmp(argv[i], "--write-reduced=", 16)) { reduced_file = argv[i] + 16; }
+        else if (!strncmp(argv[i], "--var-map=", 10)) { map_file = argv[i] + 10; }
+        else if (!strncmp(argv[i], "--checkpoint=", 13)) { checkpoint_file = argv[i] + 13; }
+        else if (!strncmp(argv[i], "--checkpoint-interval=", 22)) { checkpoint_interval = atof(argv[i] + 22); }
+        else if (!strncmp(argv[i], "--resume=", 9)) { resume_file = argv[i] + 9; }
+        else if (!strncmp(argv[i], "--export-clauses=", 17)) { export_file = argv[i] + 17; }
+        else if (!strncmp(argv[i], "--export-lbd=", 13)) { export_lbd = atoi(argv[i] + 13); }
+        else if (!strncmp(argv[i], "--export-size=", 14)) { export_size = atoi(argv[i] + 14); }
+        else if (!strncmp(argv[i], "--import-clauses=", 17)) { import_file = argv[i] + 17; }
+        else if (!strcmp(argv[i], "--import-unchecked")) { import_unchecked = true; }
+        else if (!strcmp(argv[i], "--huge-pages=off")) { current_memory_policy.huge_pages = memory_policy::normal; }
+        else if (!strcmp(argv[i], "--huge-pages=thp")) { current_memory_policy.huge_pages = memory_policy::transparent; }
+        else if (!strcmp(argv[i], "--huge-pages=explicit")) { current_memory_policy.huge_pages = memory_policy::explicit_huge; }
+        else if (!strncmp(argv[i], "--numa-node=", 12)) { current_memory_policy.numa_node = atoi(argv[i] + 12); }
+        else if (argv[i][0] != '-' && !input_file) { input_file = argv[i]; }
+        else if (!strncmp(argv[i], "--config=", 9)) {
+            config = find_configuration(argv[i] + 9);
+            chose_config = true;
+            if (!config) {
+                cerr << "unknown configuration " << argv[i] + 9 << "; we have:" << endl;
+                for (const auto& conf : configurations) {
+                    cerr << "  " << conf.name << ": " << conf.description << endl;
                 }
-                a.pop_single_lit();
-                ASSERT(clause_unsat(p, a));
+                return 1;
             }
+        }
+        else {
+            cerr << "usage: " << argv[0] << " [--config=NAME] [--renumber] [--bce | --cce] [--model] [--proof=FILE [--lrat]]"
+                 << " [--components [--redecompose] [--threads=N]]"
+                 << " [--stats] [--progress=SECONDS] [--stats-json=FILE] [--profile=FILE]"
+                 << " [--cube=ASSIGNMENT [--write-reduced=FILE] [--var-map=FILE]]"
+                 << " [--checkpoint=FILE [--checkpoint-interval=SECONDS]] [--resume=FILE]"
+                 << " [--export-clauses=FILE [--export-lbd=N] [--export-size=N]]"
+                 << " [--import-clauses=FILE [--import-unchecked]]"
+                 << " [--huge-pages=off|thp|explicit] [--numa-node=N] [input.cnf]" << endl;
+            return 1;
+        }
+    }
 
-            // we better not have actually backtracked beyond our current level.
-            ASSERT(a.curr_level() == old_level);
-            literal uip = has_uip(p, a);
-            TRACE("Found uip: ", uip, "\n");
-            TRACE("With clause: ", p, "\n");
-            ASSERT(uip != 0);
-            uip = -uip;
-            ASSERT(clause_unsat(p, a));
+#ifndef PROFILE_ON
+    if (profile_file) {
+        cerr << "--profile needs a build with -D PROFILE_ON (make sat-profile)" << endl;
+        return 1;
+    }
+#endif
 
-            int clause_lbd = g.calculate_lbd(a, p);
+    if (renumber && proof_file) {
+        // The proof would have to be written in the input's numbering
+        // (and clause order, for LRAT); we don't do that yet.
+        cerr << "--renumber can't be combined with --proof" << endl;
+        return 1;
+    }
+    if (eliminate_blocked && proof_file && proof_format == proof_tracer::lrat) {
+        // LRAT numbers the input's clauses, and some of them are gone.
+        // (A DRAT proof of what's left is still one of the input.)
+        cerr << "--bce and --cce can't be combined with --lrat" << endl;
+        return 1;
+    }
+    if (split && proof_file) {
+        // Each component would have its own proof, in its own names.
+        cerr << "--components can't be combined with --proof" << endl;
+        return 1;
+    }
+    if (proof_file && !config->proofs) {
+        cerr << "configuration " << config->name << " can't write proofs" << endl;
+        return 1;
+    }
+    if (cube_file && proof_file) {
+        // Likewise: a proof of the reduced formula isn't one of the input.
+        // Write the reduced formula out and solve that instead.
+        cerr << "--cube can't be combined with --proof; use --write-reduced" << endl;
+        return 1;
+    }
+    if ((reduced_file || map_file) && !cube_file) {
+        cerr << "--write-reduced and --var-map need --cube" << endl;
+        return 1;
+    }
+    if ((checkpoint_file || resume_file) &&
+        (proof_file || split || eliminate_blocked || renumber || cube_file)) {
+        // A snapshot is of the formula the search sees, and a resumed run
+        // wouldn't know how to get a model (or a proof) of the input back.
+        cerr << "--checkpoint and --resume can't be combined with --proof, --components,"
+             << " --bce, --cce, --renumber or --cube" << endl;
+        return 1;
+    }
+    if ((export_file || import_file) &&
+        (proof_file || split || eliminate_blocked || renumber || cube_file || resume_file)) {
+        // Likewise: the clauses would be in another formula's names, or
+        // only implied by a simplified one. (And a proof has no way to
+        // bring in clauses it didn't derive.)
+        cerr << "--export-clauses and --import-clauses can't be combined with --proof, --components,"
+             << " --bce, --cce, --renumber, --cube or --resume" << endl;
+        return 1;
+    }
 
-            // At this point p is a clause that has a UIP.
-            // We should first learn it, and then backtrack.
-            // We must apply what we've learned to avoid infinite
-            // looping (see useful lecture notes).
-            //
-            // Note that p is now a new unit clause, given a.
-            // And that it's asserting the UIP.
-            // That may induce more BCP.
-            // However, something inconsistent would arise in the case
-            // where *that* BCP would induce more conflict: if p is
-            // asserting using only assignments from "much earlier"
-            // decision levels, then if we imagine ourselves going back
-            // in time where the CNF always had p, we would have backtracked
-            // even then.
-            //
-            // The point is, in that second-order conflict case, the unit
-            // propogation induced by the UIP isn't honestly associated
-            // at the latest decision level.
-            //
-            // To head that off, we do the NCB so that we go back in time
-            // just to when the learned clause P should have always
-            // been there.
-            //
-            // Note: another weird case is that our decision variable
-            // itself may be the UIP.
-            // Nonetheless, the desired level is the max level of the learend
-            // clause --without-- the UIP literal.
-            //
-            // What if the clause is unit? In that case the max level is
-            // defined as 0. That actually seems somewhat well-defined.
+    // A snapshot has the formula in it, and says which configuration it's for.
+    std::unique_ptr<input_buffer> snapshot;
+    std::unique_ptr<checkpoint_reader> resume;
+    if (resume_file) {
+        if (input_file) {
+            cerr << "--resume reads the formula from the snapshot; there's no input file" << endl;
+            return 1;
+        }
+        snapshot = std::make_unique<input_buffer>(resume_file);
+        if (!snapshot->ok) {
+            cerr << "cannot open " << resume_file << endl;
+            return 1;
+        }
+        resume = std::make_unique<checkpoint_reader>(snapshot->begin(), snapshot->end());
+        const configuration* saved = resume->ok ? find_configuration(resume->config.c_str()) : nullptr;
+        if (!saved) {
+            cerr << resume_file << " isn't a snapshot we can resume" << endl;
+            return 1;
+        }
+        if (chose_config && config != saved) {
+            cerr << resume_file << " was taken with --config=" << saved->name << endl;
+            return 1;
+        }
+        config = saved;
+    }
 
-            a.pop_level();
-            ASSERT(std::all_of(begin(c), end(c), [&](const auto cl) {
-                return !clause_implies(cl, a) || size(cl) == 1;
-            }));
-            // There should be at least 1 unassigned literal in p,
-            // and it should not somehow be made sat...
-            ASSERT(!clause_unsat(p, a));
-            ASSERT(!clause_sat(p, a));
-            ASSERT(end(c) == has_conflict(c, a));
-            p.erase(uip);
-            ASSERT(clause_unsat(p, a));
-            // Note that this is *inclusive", we want to keep all the assigned
-            // literals in p.
-            int max_level = a.max_literal_level(p);
-            TRACE("NCB backtrack level: ", max_level, "\n");
-            // we can be = because we already popped a level.
-            ASSERT(max_level <= a.curr_level());
-            while (a.curr_level() > max_level) {
-                a.pop_level();
+    // With a cube, we reduce the input as we read it (see cube.h).
+    std::unique_ptr<cube_reduction> cube;
+    if (cube_file) {
+        input_buffer assignment(cube_file);
+        input_buffer input(input_file ? input_file : "-");
+        if (!assignment.ok || !input.ok) {
+            cerr << "cannot open " << (assignment.ok ? input_file : cube_file) << endl;
+            return 1;
+        }
+        cube = std::make_unique<cube_reduction>();
+        cube->read_cube(assignment);
+        cube->reduce(input);
+        if (map_file) {
+            FILE* f = fopen(map_file, "w");
+            if (!f) {
+                cerr << "cannot open " << map_file << endl;
+                return 1;
             }
-            // 
-            // now we've made a unit clause!
-            p.insert(uip);
-            ASSERT(uip == clause_implies(p, a));
-
-            // At this point we've cleared our watch literals, so
-            // we better not have any more conflict or unit clauses...
-            ASSERT(std::all_of(begin(c), end(c), [&](const auto cl) {
-                return !clause_implies(cl, a) || size(cl) == 1;
-            }));
-
-            // We learn and apply.
-            c.consider_resizing();
-            if (g.current_clause_count <= c.clauses_count) {
-                int n = 0;
-                auto m = g.generate_mapping(c, a, n);
-                c.remap_clauses(m.get(), n);
-                g.current_clause_count *= 1.3;
+            cube->write_map(f);
+            fclose(f);
+        }
+        if (reduced_file) {
+            FILE* f = strcmp(reduced_file, "-") ? fopen(reduced_file, "w") : stdout;
+            if (!f) {
+                cerr << "cannot open " << reduced_file << endl;
+                return 1;
             }
+            {
+                dimacs_sink out(f);
+                cube->write(out);
+            }
+            if (f != stdout) { fclose(f); }
+            return 0;
+        }
+        if (cube->has_empty_clause) {
+            cout << 0 << endl;
+            return 0;
+        }
+    }
 
-            // Learn the clause!
-            auto new_clause_ptr = c.insert_clause(p);
-
-            g.lbd[new_clause_ptr] = clause_lbd;
-            w.add_clause(new_clause_ptr, uip, a);
-            ASSERT(uip == clause_implies(new_clause_ptr, a));
-            a.push_implicant(uip, new_clause_ptr);
-            v.apply_clause(new_clause_ptr);
-            w.apply(a, uip);
+    auto table = [&]() {
+        if (resume) { return get_formula(*resume); }
+        if (cube) {
+            cnf_sink sink;
+            cube->write(sink);
+            return sink.take();
+        }
+        if (input_file) {
+            ifstream in(input_file);
+            return load_cnf(cnf_reader::cnf_from_stream(in));
+        }
+        return load_cnf();
+    }();
+    if (resume && !resume->ok) {
+        cerr << resume_file << " isn't a snapshot we can resume" << endl;
+        return 1;
+    }
 
-            conflict_counter++;
+    // Clauses from an earlier run go on the end, as learned (see clause_exchange.h).
+    search_control control;
+    const unsigned long hash = (export_file || import_file) ? clause_set_hash(table) : 0;
+    if (import_file) {
+        ifstream in(import_file);
+        if (!in) {
+            cerr << "cannot open " << import_file << endl;
+            return 1;
+        }
+        learned_import learned(in);
+        if (!learned.ok || learned.variables > table.max_literal_count / 2) {
+            cerr << import_file << " isn't a set of learned clauses for this formula" << endl;
+            return 1;
+        }
+        if (learned.hash != hash && !import_unchecked) {
+            cerr << "c " << import_file << " was learned from a different formula; not using it"
+                 << " (--import-unchecked if this one only has more clauses)" << endl;
         }
         else {
-
-            ASSERT(std::all_of(begin(c), end(c), [&](const auto cl) {
-                if (clause_implies(cl, a) && size(cl) > 1) {
-                    std::cout << "Problem clause: " << cl << std::endl;
+            for (const auto& cl : learned.clauses) {
+                while (table.remaining_size() < int(cl.second.size()) || !table.remaining_clauses()) {
+                    table.consider_resizing();
                 }
-                return !clause_implies(cl, a) || size(cl) == 1;
-            }));
-
-            //if (conflict_counter >= 512) {
-            //    conflict_counter = 0;
-            //    a.restart();
-            //}
-
-            //literal decision = decide_literal(c, a);
-            literal decision = v.get_literal(a);
-            if (decision == 0) { return true; }
-            TRACE("decision: ", decision, "\n");
-
-            // increments the decision level
-            a.push_decision(decision);
-            w.apply(a, decision);
+                table.insert_clause(cl.second);
+                control.imported_lbds.push_back(cl.first);
+            }
+            STAT(stats.imported_clauses = learned.clauses.size());
         }
     }
-}
-
-using namespace std;
-namespace cnf_reader {
-
-
-    using namespace std;
-    typedef int variable;
-    typedef int literal;
+    std::unique_ptr<learned_export> exporter;
+    if (export_file) {
+        exporter = std::make_unique<learned_export>(export_lbd, export_size);
+        control.export_clauses = exporter.get();
+    }
 
-    typedef small_set<literal> basic_clause;
-    typedef vector<basic_clause> basic_cnf;
+    std::unique_ptr<blocked_clause_elimination> blocked;
+    if (eliminate_blocked) {
+        blocked = std::make_unique<blocked_clause_elimination>(table, eliminate_covered);
+        table = blocked->apply(table);
+        STAT(stats.blocked_clauses = blocked->blocked);
+        STAT(stats.covered_clauses = blocked->covered);
+    }
+    std::unique_ptr<renumbering> names;
+    if (renumber) {
+        names = std::make_unique<renumbering>(table);
+        table = names->apply(table);
+    }
 
-    basic_cnf cnf_from_stdin() {
-        // very simple parsing, assuming things are pretty well-formatted.
-        basic_cnf result;
-        std::string line;
-        while (getline(std::cin, line)) {
-            if (line.size() < 1 ||
-                    line[0] == 'c' ||
-                    line[0] == 'p') {
-                continue;
-            }
-            if (line[0] == '%') { break; }
-            basic_clause new_clause;
-            auto to_parse = std::istringstream(line);
-            std::istream_iterator<literal> literal_reader{to_parse};
-            std::istream_iterator<literal> end_of_line;
-            while (literal_reader != end_of_line) {
-                literal l = *literal_reader++;
-                if (l == 0) { break; }
-                new_clause.insert(l);
+    bool result;
+    bool interrupted = false;
+    vector<literal> model;
+    if (proof_file) {
+        FILE* f = fopen(proof_file, "wb");
+        if (!f) {
+            cerr << "cannot open proof file " << proof_file << endl;
+            return 1;
+        }
+        {
+            // The tracer's destructor drains its writer thread.
+            proof_tracer proof(table, f, proof_format);
+            result = config->solve_with_proof(table, stats, model, proof);
+        }
+        fclose(f);
+    }
+    else if (split) {
+        result = solve_components(*config, table, stats, model, threads, redecompose);
+    }
+    else if (checkpoint_file || resume || import_file || export_file) {
+        control.resume = resume.get();
+        std::unique_ptr<checkpointer> saver;
+        if (checkpoint_file) {
+            saver = std::make_unique<checkpointer>(checkpoint_file, config->name, checkpoint_interval);
+            control.checkpoint = saver.get();
+            control.stop = &terminating;
+            signal(SIGTERM, on_sigterm);
+        }
+        result = config->solve(table, stats, model, &control);
+        interrupted = control.interrupted;
+        if (saver) {
+            saver->finish();
+            STAT(stats.checkpoint_write_seconds = saver->write_seconds);
+            if (saver->failed) { cerr << "couldn't write " << checkpoint_file << endl; }
+        }
+        if (interrupted) { cerr << "c interrupted; carry on with --resume=" << checkpoint_file << endl; }
+        if (exporter) {
+            FILE* f = fopen(export_file, "w");
+            if (!f) {
+                cerr << "cannot open " << export_file << endl;
+                return 1;
             }
-            result.push_back(new_clause);
+            const long n = exporter->write(f, hash, table.max_literal_count / 2);
+            (void)n;
+            fclose(f);
+            STAT(stats.exported_clauses = n);
         }
-        return result;
     }
-}
-
-cnf load_cnf() {
-    auto simple_table = cnf_reader::cnf_from_stdin();
-    int size = 0;
-    int literal_count = 0;
-    int clause_count = 0;
-    for (auto cl : simple_table) {
-        size += cl.size();
-        clause_count++;
-        for (auto x : cl) {
-            auto y = std::abs(x);
-            literal_count = std::max(literal_count, y);
+    else {
+        result = config->solve(table, stats, model, nullptr);
+    }
+    if (!interrupted) { cout << result << endl; }
+    if (result && show_model) {
+        // Back through each renaming to the input's names.
+        if (names) {
+            for (auto& l : model) { l = names->to_old(l); }
         }
+        int variables = table.max_literal_count / 2;
+        if (blocked) { model = blocked->extend(model, variables); }
+        if (cube) {
+            model = cube->lift(model);
+            variables = cube->input_variable_count();
+        }
+        print_model(cout, model, variables);
     }
-    literal_count *= 2;
-
-    cnf result(size, clause_count, literal_count);
 
-    for (auto cl : simple_table) {
-        result.insert_clause(cl);
+    stats.measure(table);
+    if (print_stats) { stats.print_summary(cerr); }
+    if (json_file) {
+        ofstream json(json_file);
+        stats.print_json(json);
     }
-    return result;
-}
-
-int main(int argc, char* argv[]) {
-    auto table = load_cnf();
-    cout << solve(table) << endl;
+    PROFSTMT(profiler::instance().print_report(cerr));
+    if (profile_file) {
+        ofstream folded(profile_file);
+        PROFSTMT(profiler::instance().print_folded(folded));
+    }
+    return interrupted ? 1 : 0;
 }
@@ -0,0 +1,669 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include "cnf.h"
+#include "assignment.h"
+#include "watched_literals.h"
+#include "vsids.h"
+#include "vmtf.h"
+#include "lrb.h"
+#include "evsids.h"
+#include "modes.h"
+#include "restarts.h"
+#include "backtracking.h"
+#include "reduction.h"
+#include "local_search.h"
+#include "xor.h"
+#include "proof.h"
+#include "checkpoint.h"
+#include "clause_exchange.h"
+#include "stats.h"
+#include "profiler.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <cstring>
+
+literal has_uip(flexsize_clause& p, assignment& a) {
+    int hitcount = 0;
+    literal r;
+    // we increment by 1 because we ignore the actual decision level.
+    std::for_each(a.first_lit_latest_level(),
+                  a.last_lit_latest_level(),
+                  [&](literal l) {
+        if (p.contains(-l)) {
+            r = l;
+            hitcount++;
+        }
+    });
+    ASSERT(hitcount > 0);
+    if (hitcount == 1) { return r; }
+    TRACE("Not a uip!", p, "\n");
+    return literal();
+}
+
+// Trace backwards from the conflict to make p a UIP: resolve against the
+// reasons on the trail until there's only one literal from our decision
+// level left. Note this pops the trail as it goes (but never past the
+// current level's decision).
+template<typename Tracer, typename Heuristic>
+void analyze_conflict(flexsize_clause& p, assignment& a,
+                      cnf::clause_iterator conflict_clause,
+                      Tracer& proof, Heuristic& v) {
+    PROFILE_SCOPE(phase_analyze);
+    p.adopt(conflict_clause); // a helper class with easier resolution.
+    while (!has_uip(p, a)) {
+        DBGSTMT(if (!a.curr_lit_is_implied()) {
+            std::cout << p << std::endl << a << std::endl;
+        });
+        ASSERT(a.curr_lit_is_implied());
+        // we have to resolve against our reasons
+        if (p.contains(-a.curr_lit())) {
+            auto unit = a.curr_lit();
+            auto reason = a.curr_reason();
+            p.resolve(reason, -unit);
+            proof.resolved(reason);
+            v.analyzed(reason);
+            TRACE("Resolved p: ", p, "\n");
+        }
+        a.pop_single_lit();
+        ASSERT(clause_unsat(p, a));
+    }
+}
+
+// The same, for when the trail is out of level order (chronological
+// backtracking): only literals of the conflict level count towards the
+// UIP, and we walk the trail in place, since the lower-level literals
+// interleaved with them have to stay assigned. The conflict clause must
+// already be at the current level. Returns the UIP (its trail literal, as
+// has_uip does).
+template<typename Tracer, typename Heuristic>
+literal analyze_conflict_in_place(flexsize_clause& p, const assignment& a,
+                                  cnf::clause_iterator conflict_clause,
+                                  Tracer& proof, Heuristic& v) {
+    PROFILE_SCOPE(phase_analyze);
+    const int level = a.curr_level();
+    auto at_level = [&]() {
+        return std::count_if(begin(p), end(p), [&](literal x) {
+            return a.decision_level(-x) == level;
+        });
+    };
+    p.adopt(conflict_clause);
+    int count = at_level();
+    ASSERT(count > 1);
+    for (int i = a.assigned_count - 1; ; --i) {
+        ASSERT(i >= 0);
+        literal l = a.begin()[i];
+        if (a.decision_level(l) != level || !p.contains(-l)) { continue; }
+        if (count == 1) { return l; }
+        auto reason = a.reason_at(i);
+        ASSERT(reason);
+        p.resolve(reason, -l);
+        proof.resolved(reason);
+        v.analyzed(reason);
+        TRACE("Resolved p: ", p, "\n");
+        count = at_level();
+    }
+}
+
+// How someone else can step into a search. They can cut it short
+// (components.h does both): by setting stop, or by asking us to stop once
+// root_units literals are fixed at the root, handing those over. Either
+// way solve() returns false without an answer, and says so in
+// interrupted. With checkpoint, we hand it a snapshot whenever it says one
+// is due, and when we're stopped; with resume, we start from one (the
+// formula's already been read from it; see checkpoint.h).
+//
+// The last imported_lbds.size() clauses of the formula were learned in an
+// earlier run, and go in as learned with those LBDs; at the end, what we
+// learned goes to export_clauses (see clause_exchange.h).
+struct search_control {
+    const std::atomic<bool>* stop = nullptr;
+    int root_units = 0; // 0 for no limit
+    bool interrupted = false;
+    std::vector<literal> units;
+    checkpointer* checkpoint = nullptr;
+    checkpoint_reader* resume = nullptr;
+    std::vector<int> imported_lbds;
+    learned_export* export_clauses = nullptr;
+};
+
+// The CDCL loop, specialized at compile time. Config names the policies:
+//     propagator        BCP (watched_literals)
+//     heuristic         picks decisions, and hears about what goes on and off
+//                       the trail, analysis, and learned clauses (vsids,
+//                       vmtf, lrb, evsids); it can ask for restarts too
+//                       (stable_focused in modes.h, which switches between
+//                       two of them)
+//     restart_policy    see restarts.h
+//     reduction_policy  see reduction.h
+//     local_search      see local_search.h
+//     xor_engine        parity reasoning at each BCP fixpoint (xor.h)
+//     backtracking      how far to go back after learning (backtracking.h)
+// and Tracer is proof_tracer or null_tracer. Every combination we
+// instantiate is its own fully-inlined loop, so there's no dispatch inside
+// the search; the choice is made once, by the table at the bottom.
+template<typename Config, typename Tracer>
+class solver {
+    using propagator = typename Config::propagator;
+    using heuristic = typename Config::heuristic;
+    using restart_policy = typename Config::restart_policy;
+    using reduction_policy = typename Config::reduction_policy;
+    using local_search = typename Config::local_search;
+    using xor_engine = typename Config::xor_engine;
+    using backtracking = typename Config::backtracking;
+
+    cnf& c;
+    statistics& stats;
+    Tracer& proof;
+
+    // Create all the helper data structures.
+    assignment         a;
+    propagator         w;
+    reduction_policy   d;
+    heuristic          v;
+    restart_policy     r;
+    local_search       ls;
+    xor_engine         x;
+    backtracking       bt;
+
+    flexsize_clause    p;
+
+    search_control* control;
+    bool interrupted();
+    void save_checkpoint();
+
+    // Chronological backtracking (when backtracking::chronological).
+    void backtrack_to(int target, int& changed_from);
+    void repropagate(int from);
+    bool learn_chronologically(cnf::clause_iterator conflict_clause);
+
+public:
+    // If we find a satisfying assignment, the literals it makes true.
+    std::vector<literal> model;
+
+    solver(cnf& c, statistics& stats, Tracer& proof, search_control* control = nullptr):
+        c(c), stats(stats), proof(proof),
+        a(c), w(c), d(c), v(c, stats), ls(c), x(c, stats), p(c), control(control)
+    {}
+
+    bool solve();
+
+    void export_learned(learned_export& out) {
+        for (auto cit = c.clause_begin(); cit != c.clause_end(); ++cit) { out.consider(d.lbd(cit), cit); }
+    }
+};
+
+template<typename Config, typename Tracer>
+bool solver<Config, Tracer>::solve() {
+    PROFILE_SCOPE(phase_solve);
+    if (control) {
+        const int first = c.clauses_count - control->imported_lbds.size();
+        for (size_t i = 0; i < control->imported_lbds.size(); ++i) {
+            d.learned(c.clause_begin() + first + i, control->imported_lbds[i]);
+        }
+    }
+    if (control && control->resume) {
+        // The saved phases stand in for whatever local search would find.
+        d.load(*control->resume, c);
+        v.load(*control->resume);
+        r.load(*control->resume);
+    }
+    else if (ls.before_search(v, stats, model)) { return true; }
+    for (;;) {
+        p.clear();
+        TRACE("main loop start\n");
+
+
+        ASSERT(c.sanity_check());
+        ASSERT(a.sanity_check());
+        ASSERT(w.sanity_check());
+        TRACE(a, "\n", c, "\n");
+
+        // (Out of order, going back can leave a second conflict at a lower
+        // level in place; it'll be the next thing BCP finds.)
+        ASSERT(has_conflict(c, a) == end(c) ||
+               (backtracking::chronological && w.has_units()));
+
+        // We start out with BCP. This covers degenerate inputs,
+        // and leads to a cleaner induction loop.
+        // This means that upon backtracking, we have to promise that we've
+        // already computed the units.
+        cnf::clause_iterator conflict_clause = nullptr;// has_conflict(c, a);
+        TRACE("BCP: start\n");
+
+        // BCP, then the xor engine, until neither has anything new.
+        for (;;) {
+            PROFILE_SCOPE(phase_bcp);
+            while (w.has_units()) {
+                literal unit; cnf::clause_iterator reason;
+                std::tie(unit, reason) = w.pop_unit();
+                TRACE("BCP: unit = ", unit, ", reason = ", reason, "\n");
+                if (clause_unsat(reason, a)) {
+                    TRACE("BCP: reason is conflict, breaking.\n");
+                    conflict_clause = reason;
+                    w.clear_units();
+                    break;
+                }
+                else {
+                    TRACE("BCP: pushing implicant ", unit, " -> ", reason, "\n");
+                    ASSERT(unit == clause_implies(reason, a));
+                    if (backtracking::chronological) {
+                        a.push_implicant(unit, reason, a.implication_level(reason, unit));
+                    }
+                    else {
+                        a.push_implicant(unit, reason);
+                    }
+                    v.assigned(unit);
+                    STAT(stats.propagations++);
+                    w.apply(a, unit);
+                }
+            }
+            if (conflict_clause) { break; }
+            conflict_clause = x.propagate(c, a, w, d, stats);
+            if (x.unsat) { return false; }
+            if (conflict_clause || !w.has_units()) { break; }
+        }
+        TRACE("BCP: done\n");
+
+        // If there's a conflict, we'll learn from that
+        // and continue.
+        if (conflict_clause) {
+            STAT(stats.conflicts++);
+            if (backtracking::chronological) {
+                if (!learn_chronologically(conflict_clause)) { return false; }
+                r.on_conflict();
+                STAT(stats.tick(c));
+                if (interrupted()) { return false; }
+                continue;
+            }
+            if (a.curr_level() == -1) {
+                proof.add_empty_clause(a, conflict_clause);
+                return false;
+            }
+
+            DBGSTMT(const int old_level = a.curr_level());
+            const int trail_end = a.assigned_count;
+            analyze_conflict(p, a, conflict_clause, proof, v);
+
+            // we better not have actually backtracked beyond our current level.
+            ASSERT(a.curr_level() == old_level);
+            literal uip = has_uip(p, a);
+            TRACE("Found uip: ", uip, "\n");
+            TRACE("With clause: ", p, "\n");
+            ASSERT(uip);
+            uip = -uip;
+            ASSERT(clause_unsat(p, a));
+
+            int clause_score = d.score(a, p);
+
+            // At this point p is a clause that has a UIP.
+            // We should first learn it, and then backtrack.
+            // We must apply what we've learned to avoid infinite
+            // looping (see useful lecture notes).
+            //
+            // Note that p is now a new unit clause, given a.
+            // And that it's asserting the UIP.
+            // That may induce more BCP.
+            // However, something inconsistent would arise in the case
+            // where *that* BCP would induce more conflict: if p is
+            // asserting using only assignments from "much earlier"
+            // decision levels, then if we imagine ourselves going back
+            // in time where the CNF always had p, we would have backtracked
+            // even then.
+            //
+            // The point is, in that second-order conflict case, the unit
+            // propogation induced by the UIP isn't honestly associated
+            // at the latest decision level.
+            //
+            // To head that off, we do the NCB so that we go back in time
+            // just to when the learned clause P should have always
+            // been there.
+            //
+            // Note: another weird case is that our decision variable
+            // itself may be the UIP.
+            // Nonetheless, the desired level is the max level of the learend
+            // clause --without-- the UIP literal.
+            //
+            // What if the clause is unit? In that case the max level is
+            // defined as 0. That actually seems somewhat well-defined.
+
+            a.pop_level();
+            ASSERT(std::all_of(begin(c), end(c), [&](const auto cl) {
+                return !clause_implies(cl, a) || size(cl) == 1;
+            }));
+            // There should be at least 1 unassigned literal in p,
+            // and it should not somehow be made sat...
+            ASSERT(!clause_unsat(p, a));
+            ASSERT(!clause_sat(p, a));
+            ASSERT(end(c) == has_conflict(c, a));
+            p.erase(uip);
+            ASSERT(clause_unsat(p, a));
+            // Note that this is *inclusive", we want to keep all the assigned
+            // literals in p.
+            int max_level = a.max_literal_level(p);
+            TRACE("NCB backtrack level: ", max_level, "\n");
+            // we can be = because we already popped a level.
+            ASSERT(max_level <= a.curr_level());
+            while (a.curr_level() > max_level) {
+                a.pop_level();
+            }
+            v.unassigned(a.end(), a.begin() + trail_end);
+            // 
+            // now we've made a unit clause!
+            p.insert(uip);
+            ASSERT(uip == clause_implies(p, a));
+
+            // At this point we've cleared our watch literals, so
+            // we better not have any more conflict or unit clauses...
+            ASSERT(std::all_of(begin(c), end(c), [&](const auto cl) {
+                return !clause_implies(cl, a) || size(cl) == 1;
+            }));
+
+            // The proof has to see the lemma before any of its
+            // antecedents can be reduced away.
+            proof.add_clause(p, conflict_clause);
+
+            // We learn and apply.
+            c.consider_resizing();
+            d.maybe_reduce(c, a, proof, stats);
+
+            // Learn the clause!
+            auto new_clause_ptr = c.insert_clause(p);
+            proof.inserted(new_clause_ptr);
+
+            d.learned(new_clause_ptr, clause_score);
+            w.add_clause(new_clause_ptr, uip, a);
+            ASSERT(uip == clause_implies(new_clause_ptr, a));
+            a.push_implicant(uip, new_clause_ptr);
+            v.assigned(uip);
+            STAT(stats.learned_clauses++);
+            STAT(stats.learned_literals += size(new_clause_ptr));
+            STAT(stats.propagations++);
+            v.learned(a, new_clause_ptr);
+            w.apply(a, uip);
+
+            r.on_conflict();
+            STAT(stats.tick(c));
+            if (interrupted()) { return false; }
+        }
+        else {
+
+            ASSERT(std::all_of(begin(c), end(c), [&](const auto cl) {
+                if (clause_implies(cl, a) && size(cl) > 1) {
+                    std::cout << "Problem clause: " << cl << std::endl;
+                }
+                return !clause_implies(cl, a) || size(cl) == 1;
+            }));
+
+            if (r.should_restart() || v.should_restart()) {
+                TRACE("restart\n");
+                if (ls.on_restart(a, v, stats, model)) { return true; }
+                STAT(stats.restarts++);
+                if (backtracking::chronological) {
+                    // Some of what's left may need propagating again.
+                    int changed_from = a.assigned_count;
+                    backtrack_to(-1, changed_from);
+                    repropagate(changed_from);
+                    if (w.has_units()) { continue; }
+                }
+                else {
+                    const int trail_end = a.assigned_count;
+                    a.restart();
+                    v.unassigned(a.end(), a.begin() + trail_end);
+                }
+            }
+
+            //literal decision = decide_literal(c, a);
+            literal decision = v.get_literal(a);
+            if (!decision) {
+                model.assign(a.begin(), a.end());
+                return true;
+            }
+            TRACE("decision: ", decision, "\n");
+
+            // increments the decision level
+            a.push_decision(decision);
+            v.assigned(decision);
+            STAT(stats.decisions++);
+            w.apply(a, decision);
+        }
+    }
+}
+
+// Checked after each conflict; root units only show up right after we've
+// learned one.
+template<typename Config, typename Tracer>
+bool solver<Config, Tracer>::interrupted() {
+    if (!control) { return false; }
+    const bool stop = control->stop && control->stop->load(std::memory_order_relaxed);
+    if (control->checkpoint && (stop || control->checkpoint->due())) { save_checkpoint(); }
+    const bool units = control->root_units && a.curr_level() == -1 &&
+                       a.assigned_count >= control->root_units;
+    if (!stop && !units) { return false; }
+    control->interrupted = true;
+    if (units) { control->units.assign(a.begin(), a.end()); }
+    return true;
+}
+
+// A snapshot of what's worth keeping: the clauses, what's fixed at the
+// root, and the policies' state. The rest of the trail isn't; a resumed
+// search starts from the root, as after a restart. Only putting it
+// together happens here; the checkpointer writes it out on its own thread.
+template<typename Config, typename Tracer>
+void solver<Config, Tracer>::save_checkpoint() {
+    STAT(const auto started = std::chrono::steady_clock::now());
+    std::vector<literal> units;
+    for (int i = 0; i < a.assigned_count; ++i) {
+        const literal l = a.begin()[i];
+        if (a.decision_level(l) == -1 && size(a.reason_at(i)) > 1) { units.push_back(l); }
+    }
+    checkpoint_writer out;
+    put_formula(out, c, units);
+    d.save(out, c);
+    v.save(out);
+    r.save(out);
+    control->checkpoint->save(std::move(out.bytes));
+    STAT(stats.checkpoints++);
+    STAT(stats.checkpoint_seconds +=
+         std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count());
+}
+
+template<typename Config, typename Tracer>
+void solver<Config, Tracer>::backtrack_to(int target, int& changed_from) {
+    const int trail_end = a.assigned_count;
+    changed_from = std::min(changed_from, a.backtrack_to(target));
+    v.unassigned(a.end(), a.begin() + trail_end);
+}
+
+// Once literals have moved on the trail, a clause can be watched by one
+// that's still false and one that's just been unassigned, with the rest
+// false too: a unit nobody noticed. Applying the moved literals again
+// finds those (and fixes up the watches); the units go to the next BCP.
+template<typename Config, typename Tracer>
+void solver<Config, Tracer>::repropagate(int from) {
+    for (int i = from; i < a.assigned_count; ++i) {
+        w.apply(a, a.begin()[i]);
+    }
+}
+
+// Conflict handling when the trail may be out of order. The conflict can
+// be below the current level (a late implication at a low level), so
+// first we go back to the conflict's own level. If just one literal of
+// the clause is from that level, there's nothing to learn: the clause
+// should have implied that literal, at its second-highest level, and now
+// does. Otherwise it's the usual 1UIP clause, but we go back to wherever
+// the policy says, the asserted literal taking its true (backjump) level.
+// False if the formula's unsat.
+template<typename Config, typename Tracer>
+bool solver<Config, Tracer>::learn_chronologically(cnf::clause_iterator conflict_clause) {
+    const int conflict_level = a.max_literal_level(conflict_clause);
+    if (conflict_level == -1) {
+        proof.add_empty_clause(a, conflict_clause);
+        return false;
+    }
+    int changed_from = a.assigned_count;
+    backtrack_to(conflict_level, changed_from);
+
+    literal only;
+    int at_level = 0, below = -1;
+    for (literal l : conflict_clause) {
+        const int l_level = a.decision_level(-l);
+        if (l_level == conflict_level) {
+            only = l;
+            at_level++;
+        }
+        else {
+            below = std::max(below, l_level);
+        }
+    }
+    if (at_level == 1) {
+        backtrack_to(below, changed_from);
+        ASSERT(only == clause_implies(conflict_clause, a));
+        a.push_implicant(only, conflict_clause, below);
+        v.assigned(only);
+        STAT(stats.propagations++);
+        w.apply(a, only);
+        repropagate(changed_from);
+        return true;
+    }
+
+    literal uip = -analyze_conflict_in_place(p, a, conflict_clause, proof, v);
+    TRACE("Found uip: ", uip, "\n");
+    TRACE("With clause: ", p, "\n");
+    ASSERT(clause_unsat(p, a));
+    int clause_score = d.score(a, p);
+
+    p.erase(uip);
+    const int backjump = a.max_literal_level(p);
+    p.insert(uip);
+    const int target = bt.target(conflict_level, backjump);
+    STAT(if (target != backjump) { stats.chrono_backtracks++; });
+    backtrack_to(target, changed_from);
+    ASSERT(uip == clause_implies(p, a));
+
+    proof.add_clause(p, conflict_clause);
+    c.consider_resizing();
+    d.maybe_reduce(c, a, proof, stats);
+
+    auto new_clause_ptr = c.insert_clause(p);
+    proof.inserted(new_clause_ptr);
+    d.learned(new_clause_ptr, clause_score);
+    w.add_clause(new_clause_ptr, uip, a);
+    a.push_implicant(uip, new_clause_ptr, backjump);
+    v.assigned(uip);
+    STAT(stats.learned_clauses++);
+    STAT(stats.learned_literals += size(new_clause_ptr));
+    STAT(stats.propagations++);
+    v.learned(a, new_clause_ptr);
+    w.apply(a, uip);
+    repropagate(changed_from);
+    return true;
+}
+
+// The pre-instantiated configurations. Each is a struct of policies;
+// adding one means a new struct and a new row in the table, and never
+// touches the code the other rows run.
+struct default_config {
+    using propagator = watched_literals;
+    using heuristic = vsids;
+    using restart_policy = no_restarts;
+    using reduction_policy = glue_reduction;
+    using local_search = no_local_search;
+    using xor_engine = no_xors;
+    using backtracking = non_chronological_backtracking;
+};
+struct luby_config : default_config {
+    using restart_policy = luby_restarts;
+};
+struct keep_all_config : default_config {
+    using reduction_policy = keep_all;
+};
+struct probsat_config : default_config {
+    using local_search = probsat_phases;
+};
+struct probsat_luby_config : luby_config {
+    using local_search = probsat_phases;
+};
+struct gauss_config : default_config {
+    using xor_engine = gauss_elimination;
+};
+struct chrono_config : default_config {
+    using backtracking = chronological_backtracking;
+};
+struct vmtf_config : default_config {
+    using heuristic = vmtf;
+};
+struct vmtf_luby_config : luby_config {
+    using heuristic = vmtf;
+};
+struct lrb_config : default_config {
+    using heuristic = lrb;
+};
+struct lrb_luby_config : luby_config {
+    using heuristic = lrb;
+};
+struct modes_config : default_config {
+    using heuristic = stable_focused<vmtf, evsids<950>>;
+};
+struct modes_lrb_config : default_config {
+    using heuristic = stable_focused<vmtf, lrb>;
+};
+
+template<typename Config>
+bool solve_with(cnf& c, statistics& stats, std::vector<literal>& model, search_control* control) {
+    null_tracer none;
+    solver<Config, null_tracer> s(c, stats, none, control);
+    bool result = s.solve();
+    if (control && control->export_clauses) { s.export_learned(*control->export_clauses); }
+    model = std::move(s.model);
+    return result;
+}
+template<typename Config>
+bool solve_with_proof(cnf& c, statistics& stats, std::vector<literal>& model, proof_tracer& proof) {
+    solver<Config, proof_tracer> s(c, stats, proof);
+    bool result = s.solve();
+    model = std::move(s.model);
+    return result;
+}
+
+struct configuration {
+    const char* name;
+    const char* description;
+    bool proofs; // false if it learns things DRAT can't check
+    bool (*solve)(cnf&, statistics&, std::vector<literal>&, search_control*);
+    bool (*solve_with_proof)(cnf&, statistics&, std::vector<literal>&, proof_tracer&);
+};
+
+#define CONFIGURATION(name, description, config) \
+    { name, description, config::xor_engine::proof_compatible, solve_with<config>, solve_with_proof<config> }
+
+const configuration configurations[] = {
+    CONFIGURATION("default", "vsids, no restarts, LBD reduction", default_config),
+    CONFIGURATION("luby", "vsids, luby restarts (unit 512), LBD reduction", luby_config),
+    CONFIGURATION("keep-all", "vsids, no restarts, never delete learned clauses", keep_all_config),
+    CONFIGURATION("probsat", "ProbSAT first, then the default with its best assignment as phases", probsat_config),
+    CONFIGURATION("probsat-luby", "ProbSAT first and at every luby restart, seeded from the trail", probsat_luby_config),
+    CONFIGURATION("vmtf", "variable move-to-front decisions with saved phases, no restarts, LBD reduction", vmtf_config),
+    CONFIGURATION("vmtf-luby", "variable move-to-front decisions with saved phases, luby restarts", vmtf_luby_config),
+    CONFIGURATION("lrb", "learning-rate branching (reason side rate, locality), no restarts, LBD reduction", lrb_config),
+    CONFIGURATION("lrb-luby", "learning-rate branching (reason side rate, locality), luby restarts", lrb_luby_config),
+    CONFIGURATION("modes", "alternating focused (vmtf, glue restarts) and stable (evsids, luby, target phases)", modes_config),
+    CONFIGURATION("modes-lrb", "alternating focused (vmtf, glue restarts) and stable (lrb, luby, target phases)", modes_lrb_config),
+    CONFIGURATION("chrono", "the default, but backtracking one level when a jump would undo over 100", chrono_config),
+    CONFIGURATION("gauss", "the default, plus xor detection and Gauss-Jordan elimination (no proofs)", gauss_config),
+};
+
+#undef CONFIGURATION
+
+// nullptr if there's no configuration by that name.
+const configuration* find_configuration(const char* name) {
+    for (const auto& conf : configurations) {
+        if (!strcmp(conf.name, name)) { return &conf; }
+    }
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef STAMPED_SET_H
+#define STAMPED_SET_H
+
+#include "debug.h"
+#include "literal_map.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Sets over small integer domains (levels, variables, literal indices)
+// where everything is O(1), for the places small_set's linear scans were
+// costing us.
+
+// Membership in 0..n-1, cleared in O(1): a member's slot holds the
+// current stamp, and clear() just moves on to the next one. No iteration;
+// that's what sparse_set is for.
+class stamped_set {
+    std::vector<unsigned> stamps;
+    unsigned stamp = 1;
+
+public:
+    explicit stamped_set(size_t n = 0): stamps(n, 0) {}
+
+    // Makes room for 0..n-1 (only ever grows).
+    void resize(size_t n) {
+        if (n > stamps.size()) { stamps.resize(n, 0); }
+    }
+    void clear() {
+        // Once every 4 billion clears we have to really do it.
+        if (++stamp == 0) {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            stamp = 1;
+        }
+    }
+    // True if i wasn't in already.
+    bool insert(size_t i) {
+        ASSERT(i < stamps.size());
+        if (stamps[i] == stamp) { return false; }
+        stamps[i] = stamp;
+        return true;
+    }
+    void erase(size_t i) { stamps[i] = 0; }
+    bool contains(size_t i) const { return stamps[i] == stamp; }
+};
+
+// Keys 0..n-1 with O(1) insert, erase, contains and clear, and the
+// members packed densely so iterating over them is only as long as they
+// are (Briggs and Torczon, "An efficient representation for sparse
+// sets"). Erasing moves the last member into the hole, as small_set did,
+// so the order's the same as it would have been there.
+class sparse_set {
+    std::vector<unsigned> dense, sparse;
+
+public:
+    explicit sparse_set(size_t n): sparse(n, 0) { dense.reserve(n); }
+
+    bool contains(unsigned k) const {
+        const unsigned i = sparse[k];
+        return i < dense.size() && dense[i] == k;
+    }
+    // True if k wasn't in already.
+    bool insert(unsigned k) {
+        if (contains(k)) { return false; }
+        sparse[k] = dense.size();
+        dense.push_back(k);
+        return true;
+    }
+    void erase(unsigned k) {
+        ASSERT(contains(k));
+        const unsigned i = sparse[k];
+        const unsigned last = dense.back();
+        dense[i] = last;
+        sparse[last] = i;
+        dense.pop_back();
+    }
+    void clear() { dense.clear(); }
+
+    int size() const { return dense.size(); }
+    bool empty() const { return dense.empty(); }
+    unsigned operator[](int i) const { return dense[i]; }
+    std::vector<unsigned>::const_iterator begin() const { return dense.begin(); }
+    std::vector<unsigned>::const_iterator end() const { return dense.end(); }
+};
+
+// One bit per literal, from the number of literals as literal_map is.
+class literal_bitset {
+    std::vector<uint64_t> words;
+
+public:
+    explicit literal_bitset(size_t literal_count): words((literal_count + 2 + 63) / 64, 0) {}
+
+    void insert(literal l) { words[l.index() >> 6] |= uint64_t(1) << (l.index() & 63); }
+    void erase(literal l) { words[l.index() >> 6] &= ~(uint64_t(1) << (l.index() & 63)); }
+    bool contains(literal l) const { return (words[l.index() >> 6] >> (l.index() & 63)) & 1; }
+    void clear() { std::fill(words.begin(), words.end(), 0); }
+};
+
+#endif
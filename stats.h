@@ -0,0 +1,237 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include "cnf.h"
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <sys/resource.h>
+
+// Solver counters. Like ASSERTS_ON in debug.h, these only exist if we're
+// built with STATS_ON; otherwise STAT(...) is nothing at all, so the hot
+// loops pay nothing (no formatting, no increments).
+#ifdef STATS_ON
+#define STAT(x) x
+#else
+#define STAT(x)
+#endif
+
+class statistics {
+    typedef std::chrono::steady_clock clock;
+    clock::time_point start = clock::now();
+    clock::time_point last_report = start;
+    int rows = 0;
+
+public:
+    long decisions = 0;
+    long propagations = 0;
+    long conflicts = 0;
+    long learned_clauses = 0;
+    long learned_literals = 0;
+    long restarts = 0;
+    long reductions = 0;
+    long deleted_clauses = 0;
+    long clause_db_bytes = 0;
+    long flips = 0; // local search
+    long xors = 0;  // found in the input
+    long xor_propagations = 0;
+    long xor_conflicts = 0;
+    long chrono_backtracks = 0; // backtracked one level instead of jumping
+    long blocked_clauses = 0; // removed before the search (blocked.h)
+    long covered_clauses = 0;
+    long components = 0;      // solved separately (components.h)
+    long redecompositions = 0;
+    long imported_clauses = 0; // from an earlier run (clause_exchange.h)
+    long exported_clauses = 0;
+    // Stable/focused mode switching.
+    long mode_switches = 0;
+    long focused_conflicts = 0;
+    long stable_conflicts = 0;
+    double focused_seconds = 0;
+    double stable_seconds = 0;
+    // Snapshots (checkpoint.h): putting them together, in the search, and
+    // writing them, on the side.
+    long checkpoints = 0;
+    double checkpoint_seconds = 0;
+    double checkpoint_write_seconds = 0;
+
+    // If positive, tick() prints a progress row to stderr this often.
+    double progress_interval = 0;
+
+    double elapsed() const {
+        return std::chrono::duration<double>(clock::now() - start).count();
+    }
+    static long peak_rss_kb() {
+        struct rusage r;
+        getrusage(RUSAGE_SELF, &r);
+        return r.ru_maxrss;
+    }
+    double rate(long x) const {
+        double t = elapsed();
+        return t > 0 ? x / t : 0;
+    }
+
+    // Another solver's counters (a component's, say) into ours.
+    void add(const statistics& o) {
+        decisions += o.decisions;
+        propagations += o.propagations;
+        conflicts += o.conflicts;
+        learned_clauses += o.learned_clauses;
+        learned_literals += o.learned_literals;
+        restarts += o.restarts;
+        reductions += o.reductions;
+        deleted_clauses += o.deleted_clauses;
+        flips += o.flips;
+        xors += o.xors;
+        xor_propagations += o.xor_propagations;
+        xor_conflicts += o.xor_conflicts;
+        chrono_backtracks += o.chrono_backtracks;
+        mode_switches += o.mode_switches;
+        focused_conflicts += o.focused_conflicts;
+        stable_conflicts += o.stable_conflicts;
+        focused_seconds += o.focused_seconds;
+        stable_seconds += o.stable_seconds;
+        checkpoints += o.checkpoints;
+        checkpoint_seconds += o.checkpoint_seconds;
+        checkpoint_write_seconds += o.checkpoint_write_seconds;
+    }
+
+    void measure(const cnf& c) {
+        clause_db_bytes = c.raw_data_max * sizeof(literal) +
+                          c.clauses_max * sizeof(cnf::clause);
+    }
+
+    // Called once per conflict; we only look at the clock every so often.
+    void tick(const cnf& c) {
+        if (progress_interval <= 0 || (conflicts & 255)) { return; }
+        auto now = clock::now();
+        if (std::chrono::duration<double>(now - last_report).count() < progress_interval) { return; }
+        last_report = now;
+        measure(c);
+        print_row(std::cerr, c);
+    }
+
+    void print_row(std::ostream& o, const cnf& c) {
+        if (rows++ % 20 == 0) {
+            o << "c " << std::setw(8) << "seconds"
+              << std::setw(12) << "conflicts"
+              << std::setw(12) << "decisions"
+              << std::setw(14) << "propagations"
+              << std::setw(10) << "clauses"
+              << std::setw(9) << "reduce"
+              << std::setw(12) << "props/s"
+              << std::setw(10) << "confl/s"
+              << std::setw(9) << "MB" << std::endl;
+        }
+        o << "c " << std::setw(8) << std::fixed << std::setprecision(1) << elapsed()
+          << std::setw(12) << conflicts
+          << std::setw(12) << decisions
+          << std::setw(14) << propagations
+          << std::setw(10) << c.clauses_count
+          << std::setw(9) << reductions
+          << std::setw(12) << std::setprecision(0) << rate(propagations)
+          << std::setw(10) << rate(conflicts)
+          << std::setw(9) << std::setprecision(1) << peak_rss_kb() / 1024.0 << std::endl;
+    }
+
+    void print_summary(std::ostream& o) const {
+        auto seconds = [&](const char* name, double value) {
+            o << "c " << std::left << std::setw(18) << name << std::right
+              << std::setw(14) << std::fixed << std::setprecision(3) << value << std::endl;
+        };
+        auto line = [&](const char* name, long value, bool with_rate) {
+            o << "c " << std::left << std::setw(18) << name << std::right
+              << std::setw(14) << value;
+            if (with_rate) {
+                o << std::setw(14) << std::fixed << std::setprecision(0)
+                  << rate(value) << " per second";
+            }
+            o << std::endl;
+        };
+        seconds("time (s)", elapsed());
+        line("decisions", decisions, true);
+        line("propagations", propagations, true);
+        line("conflicts", conflicts, true);
+        line("learned clauses", learned_clauses, false);
+        line("learned literals", learned_literals, false);
+        line("restarts", restarts, false);
+        line("reductions", reductions, false);
+        line("deleted clauses", deleted_clauses, false);
+        // The rest only mean something for some configurations and flags;
+        // rows for what didn't run are left out.
+        if (flips) { line("flips", flips, true); }
+        if (xors) {
+            line("xors", xors, false);
+            line("xor propagations", xor_propagations, false);
+            line("xor conflicts", xor_conflicts, false);
+        }
+        if (chrono_backtracks) { line("chrono backtracks", chrono_backtracks, false); }
+        if (blocked_clauses || covered_clauses) {
+            line("blocked clauses", blocked_clauses, false);
+            line("covered clauses", covered_clauses, false);
+        }
+        if (components) {
+            line("components", components, false);
+            line("redecompositions", redecompositions, false);
+        }
+        if (imported_clauses) { line("imported clauses", imported_clauses, false); }
+        if (exported_clauses) { line("exported clauses", exported_clauses, false); }
+        if (focused_conflicts || stable_conflicts) {
+            line("mode switches", mode_switches, false);
+            line("focused conflicts", focused_conflicts, false);
+            seconds("focused time (s)", focused_seconds);
+            line("stable conflicts", stable_conflicts, false);
+            seconds("stable time (s)", stable_seconds);
+        }
+        if (checkpoints) {
+            line("checkpoints", checkpoints, false);
+            seconds("snapshot time (s)", checkpoint_seconds);
+            seconds("write time (s)", checkpoint_write_seconds);
+        }
+        line("clause db (KB)", clause_db_bytes / 1024, false);
+        line("peak rss (KB)", peak_rss_kb(), false);
+    }
+
+    void print_json(std::ostream& o) const {
+        o << std::fixed << std::setprecision(3)
+          << "{\"time\": " << elapsed()
+          << ", \"decisions\": " << decisions
+          << ", \"propagations\": " << propagations
+          << ", \"conflicts\": " << conflicts
+          << ", \"learned_clauses\": " << learned_clauses
+          << ", \"learned_literals\": " << learned_literals
+          << ", \"restarts\": " << restarts
+          << ", \"reductions\": " << reductions
+          << ", \"deleted_clauses\": " << deleted_clauses
+          << ", \"flips\": " << flips
+          << ", \"xors\": " << xors
+          << ", \"xor_propagations\": " << xor_propagations
+          << ", \"xor_conflicts\": " << xor_conflicts
+          << ", \"chrono_backtracks\": " << chrono_backtracks
+          << ", \"blocked_clauses\": " << blocked_clauses
+          << ", \"covered_clauses\": " << covered_clauses
+          << ", \"components\": " << components
+          << ", \"redecompositions\": " << redecompositions
+          << ", \"imported_clauses\": " << imported_clauses
+          << ", \"exported_clauses\": " << exported_clauses
+          << ", \"mode_switches\": " << mode_switches
+          << ", \"focused_conflicts\": " << focused_conflicts
+          << ", \"focused_seconds\": " << focused_seconds
+          << ", \"stable_conflicts\": " << stable_conflicts
+          << ", \"stable_seconds\": " << stable_seconds
+          << ", \"checkpoints\": " << checkpoints
+          << ", \"checkpoint_seconds\": " << checkpoint_seconds
+          << ", \"checkpoint_write_seconds\": " << checkpoint_write_seconds
+          << ", \"clause_db_bytes\": " << clause_db_bytes
+          << ", \"peak_rss_kb\": " << peak_rss_kb()
+          << std::setprecision(1)
+          << ", \"decisions_per_second\": " << rate(decisions)
+          << ", \"propagations_per_second\": " << rate(propagations)
+          << ", \"conflicts_per_second\": " << rate(conflicts)
+          << ", \"flips_per_second\": " << rate(flips)
+          << "}" << std::endl;
+    }
+};
+
+#endif
@@ -0,0 +1,64 @@
+// Checks the vector clause scans against the scalar ones on random
+// clauses and assignments. Build with make scan-test.
+#include "clause_scan.h"
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+int main() {
+#ifdef CLAUSE_SCAN_AVX2
+    if (!clause_scan::use_avx2) {
+        cout << "no AVX2 here, nothing to compare" << endl;
+        return 0;
+    }
+    mt19937 rng(1);
+    const int vars = 100;
+    literal_map<signed char> values(2 * vars);
+    const signed char* raw = values.first_value_iter();
+    long mismatches = 0, checked = 0;
+    for (int round = 0; round < 200000; ++round) {
+        // Mostly false, as they are when we go looking.
+        int false_percent = uniform_int_distribution<int>(50, 100)(rng);
+        for (int v = 1; v <= vars; ++v) {
+            int r = uniform_int_distribution<int>(0, 99)(rng);
+            signed char x = r < false_percent ? -1 : (r % 2 ? 1 : 0);
+            literal l = literal::positive(v);
+            if (rng() % 2) { l = -l; }
+            values[l] = x;
+            values[-l] = -x;
+        }
+        vector<literal> c;
+        int len = uniform_int_distribution<int>(0, 40)(rng);
+        for (int i = 0; i < len; ++i) {
+            literal l = literal::positive(uniform_int_distribution<int>(1, vars)(rng));
+            c.push_back(rng() % 2 ? -l : l);
+        }
+        // The watches are usually in the clause, but not always.
+        literal w1 = len ? c[rng() % len] : literal();
+        literal w2 = len > 1 ? c[rng() % len] : literal();
+        if (rng() % 8 == 0) { w2 = literal(); }
+
+        const literal* b = c.data();
+        const literal* e = c.data() + c.size();
+        auto same = [&](const char* what, bool ok) {
+            checked++;
+            if (ok) { return; }
+            mismatches++;
+            cout << what << " differs on a clause of " << len << " literals" << endl;
+        };
+        same("find_replacement", clause_scan::scalar::find_replacement(b, e, raw, w1, w2) ==
+                                 clause_scan::avx2::find_replacement(b, e, raw, w1, w2));
+        same("any_true", clause_scan::scalar::any_true(b, e, raw) == clause_scan::avx2::any_true(b, e, raw));
+        same("all_false", clause_scan::scalar::all_false(b, e, raw) == clause_scan::avx2::all_false(b, e, raw));
+        same("implied", clause_scan::scalar::implied(b, e, raw) == clause_scan::avx2::implied(b, e, raw));
+    }
+    cout << checked << " checks, " << mismatches << " mismatches" << endl;
+    return mismatches != 0;
+#else
+    cout << "built without the vector kernels" << endl;
+    return 0;
+#endif
+}
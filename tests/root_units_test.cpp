@@ -0,0 +1,64 @@
+// Runs every configuration, with asserts on, on small formulas that have
+// unit clauses, which have to be set at the root before the first
+// decision. Build with make units-test.
+#include "solver.h"
+#include "generators.h"
+
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+// Whether model satisfies c; variables it leaves out count as true, as
+// sat --model prints them.
+bool satisfies(const cnf& c, const vector<literal>& model) {
+    vector<signed char> value(c.max_literal_count / 2 + 1, 1);
+    for (literal l : model) { value[l.var()] = l.is_negative() ? -1 : 1; }
+    for (auto cit = c.clause_begin(); cit != c.clause_end(); ++cit) {
+        bool sat = false;
+        for (literal l : cit) { sat = sat || value[l.var()] == (l.is_negative() ? -1 : 1); }
+        if (!sat) { return false; }
+    }
+    return true;
+}
+
+// A parity instance (its chains start and end in unit clauses), or with
+// vars 0 a few units that contradict each other if unsat, one repeated.
+cnf make_instance(int vars, int seed, bool unsat) {
+    cnf_sink sink;
+    if (vars) {
+        parity_chains(sink, vars, unsat, seed);
+    }
+    else {
+        sink.header(3, 4);
+        sink.clause({2});
+        sink.clause({2});
+        sink.clause({-1, -2, 3});
+        sink.clause({unsat ? -2 : 3});
+    }
+    return sink.take();
+}
+
+int main() {
+    long failures = 0, runs = 0;
+    for (const auto& config : configurations) {
+        for (int vars : {0, 8, 10}) {
+            for (int seed = 1; seed <= (vars ? 3 : 1); ++seed) {
+                for (bool unsat : {false, true}) {
+                    cnf c = make_instance(vars, seed, unsat);
+                    statistics stats;
+                    vector<literal> model;
+                    const bool result = config.solve(c, stats, model, nullptr);
+                    runs++;
+                    if (result == unsat || (result && !satisfies(make_instance(vars, seed, unsat), model))) {
+                        cout << config.name << ": wrong answer with vars " << vars << ", seed " << seed
+                             << (unsat ? ", unsat" : "") << endl;
+                        failures++;
+                    }
+                }
+            }
+        }
+    }
+    cout << runs << " runs, " << failures << " failures" << endl;
+    return failures ? 1 : 0;
+}
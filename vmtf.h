@@ -0,0 +1,155 @@
+#ifndef VMTF_H
+#define VMTF_H
+
+#include "literal_map.h"
+#include "assignment.h"
+#include "stats.h"
+#include "profiler.h"
+#include "checkpoint.h"
+
+#include <vector>
+#include <algorithm>
+
+// Variable move-to-front (Ryan's thesis; as in Biere and Froehlich,
+// "Evaluating CDCL Variable Scoring Schemes"). The variables sit in a
+// doubly linked queue, most recently bumped at the back, each stamped with
+// when it got there. Bumping moves a variable to the back; there are no
+// scores to decay, so a bump is O(1) and there's no floating point.
+//
+// We decide on the newest unassigned variable. To avoid walking over the
+// assigned ones every time, search is a cursor with everything newer than
+// it assigned: deciding only moves it towards the front, and it only moves
+// back when something newer than it gets unassigned (or bumped while
+// unassigned).
+//
+// Polarity is the saved phase: what the variable was last assigned to
+// (false to begin with), or what local search says.
+class vmtf {
+    std::vector<int> prev, next; // 0 at the ends
+    std::vector<unsigned long> stamp;
+    int first = 0, last = 0;
+    int search = 0;
+    unsigned long stamps = 0;
+
+    variable_map<signed char> phase;
+
+    // The variables seen in the current conflict's analysis, and (by the
+    // number of the conflict) which those were, and which came off the
+    // trail since the last one.
+    std::vector<int> bumped;
+    std::vector<unsigned long> seen, freed;
+    unsigned long conflicts = 1;
+
+    void dequeue(int v) {
+        if (prev[v]) { next[prev[v]] = next[v]; } else { first = next[v]; }
+        if (next[v]) { prev[next[v]] = prev[v]; } else { last = prev[v]; }
+        prev[v] = next[v] = 0;
+    }
+    void enqueue(int v) {
+        prev[v] = last;
+        next[v] = 0;
+        if (last) { next[last] = v; } else { first = v; }
+        last = v;
+        stamp[v] = ++stamps;
+    }
+
+    void note(literal l) {
+        const int v = l.var();
+        if (seen[v] == conflicts) { return; }
+        seen[v] = conflicts;
+        bumped.push_back(v);
+    }
+
+    public:
+    vmtf(const cnf& c, statistics&):
+        prev(c.max_literal_count / 2 + 1),
+        next(c.max_literal_count / 2 + 1),
+        stamp(c.max_literal_count / 2 + 1),
+        phase(c.max_literal_count),
+        seen(c.max_literal_count / 2 + 1),
+        freed(c.max_literal_count / 2 + 1)
+    {
+        const int n = c.max_literal_count / 2;
+        for (int v = 1; v <= n; ++v) {
+            enqueue(v);
+            phase[literal::positive(v)] = -1;
+        }
+        search = last;
+    }
+
+    literal get_literal(const assignment& a) {
+        PROFILE_SCOPE(phase_decide);
+        while (search && !a.is_unassigned(literal::positive(search))) { search = prev[search]; }
+        if (!search) { return literal(); }
+        const literal l = literal::positive(search);
+        return phase[l] < 0 ? -l : l;
+    }
+
+    void set_phase(literal l) { phase[l] = l.is_negative() ? -1 : 1; }
+
+    void assigned(literal) {}
+
+    // Conflict analysis resolved on this reason.
+    void analyzed(cnf::clause_iterator reason) {
+        for (literal l : reason) { note(l); }
+    }
+
+    // The learned clause: with the reasons, that's every variable analysis
+    // touched. Bump them all, oldest first, so they keep their order
+    // relative to each other at the back of the queue.
+    void learned(const assignment&, cnf::clause_iterator c) {
+        for (literal l : c) { note(l); }
+        std::sort(bumped.begin(), bumped.end(), [&](int x, int y) { return stamp[x] < stamp[y]; });
+        for (int v : bumped) {
+            if (v != last) {
+                dequeue(v);
+                enqueue(v);
+            }
+            // The ones we backjumped over are (but for the UIP, which it
+            // doesn't hurt to look at) unassigned, and now the newest.
+            if (freed[v] == conflicts) { search = v; }
+        }
+        bumped.clear();
+        conflicts++;
+    }
+
+    // These just came off the trail: save their phases, and if any is newer
+    // than the cursor, it moves back to it.
+    void unassigned(const literal* b, const literal* e) {
+        for (; b != e; ++b) {
+            const int v = b->var();
+            phase[literal::positive(v)] = b->is_negative() ? -1 : 1;
+            freed[v] = conflicts;
+            if (!search || stamp[v] > stamp[search]) { search = v; }
+        }
+    }
+
+    bool should_restart() { return false; }
+
+    // For checkpoint.h: the queue, front to back, and the phases. Loading
+    // queues them again in that order, which is all the stamps are for.
+    void save(checkpoint_writer& out) const {
+        for (int v = first; v; v = next[v]) { out.put_number(v); }
+        for (int v = phase.first_index(); v != phase.end_index(); ++v) { out.put_signed(phase[v]); }
+    }
+    void load(checkpoint_reader& in) {
+        const int n = prev.size() - 1;
+        std::vector<int> order(n);
+        std::vector<char> taken(n + 1, 0);
+        for (int& v : order) {
+            v = in.get_number();
+            if (v < 1 || v > n || taken[v]) {
+                in.ok = false;
+                return;
+            }
+            taken[v] = 1;
+        }
+        first = last = 0;
+        stamps = 0;
+        for (int v : order) { enqueue(v); }
+        search = last;
+        for (int v = phase.first_index(); v != phase.end_index(); ++v) { phase[v] = in.get_signed(); }
+    }
+};
+
+#endif
@@ -3,32 +3,38 @@
 
 #include "literal_map.h"
 #include "assignment.h"
+#include "stats.h"
+#include "checkpoint.h"
 
 class vsids {
     literal_map<int> frequency;
     const int max_freq;
+    // Saved phases, if someone (local search) gave us some: 1 or -1 to
+    // override the polarity of the variable we pick, 0 to leave it.
+    variable_map<signed char> phase;
+
+    int variable_count() const { return (frequency.end_index() - frequency.first_index()) / 2; }
 
     void zero_freqs() {
-        for (int i = frequency.first_index();
-                 i != frequency.end_index();
-                 ++i) {
-            if (i == 0) { continue; }
-            frequency[i] = 0;
+        for (unsigned i = frequency.first_index();
+                      i != frequency.end_index();
+                      ++i) {
+            frequency[literal(i)] = 0;
         }
     }
     void cut_freqs() {
-        for (int i = frequency.first_index();
-                 i != frequency.end_index();
-                 ++i) {
-            if (i == 0) { continue; }
-            frequency[i] /= 2;
+        for (unsigned i = frequency.first_index();
+                      i != frequency.end_index();
+                      ++i) {
+            frequency[literal(i)] /= 2;
         }
     }
 
     public:
-    vsids(const cnf& c):
+    vsids(const cnf& c, statistics&):
         frequency(c.max_literal_count),
-        max_freq(2*c.clauses_max) {
+        max_freq(2*c.clauses_max),
+        phase(c.max_literal_count) {
         zero_freqs();
         for (auto cl : c) {
             apply_clause(cl);
@@ -36,22 +42,54 @@ class vsids {
     }
 
     literal get_literal(const assignment& a) {
-        literal choice = 0;
+        PROFILE_SCOPE(phase_decide);
+        literal choice;
         int best_freq = 0;
-        for (int i = frequency.first_index();
-                 i != frequency.end_index();
-                 ++i) {
-            if (i == 0) { continue; }
-            if (!a.is_unassigned(i)) { continue; }
-
-            if (best_freq < frequency[i]) {
-                best_freq = frequency[i];
-                choice = i;
+        auto consider = [&](literal l) {
+            if (!a.is_unassigned(l)) { return; }
+            // cut_freqs can bring a literal down to 0, and it still has to
+            // be assigned: so take anything unassigned over nothing.
+            if (!choice || best_freq < frequency[l]) {
+                best_freq = frequency[l];
+                choice = l;
             }
+        };
+        // Ties go to the first literal in the order -n..-1, 1..n, which is
+        // how we scanned when literals were their DIMACS numbers; keeping it
+        // keeps the search the same.
+        const int n = variable_count();
+        for (int v = n; v >= 1; --v) { consider(-literal::positive(v)); }
+        for (int v = 1; v <= n; ++v) { consider(literal::positive(v)); }
+        if (choice && phase[choice]) {
+            choice = literal::positive(choice.var());
+            if (phase[choice] < 0) { choice = -choice; }
         }
         return choice;
     }
 
+    void set_phase(literal l) { phase[l] = l.is_negative() ? -1 : 1; }
+
+    // We only count the learned clauses' literals.
+    void assigned(literal) {}
+    void analyzed(cnf::clause_iterator) {}
+    void learned(const assignment&, cnf::clause_iterator c) { apply_clause(c); }
+    void unassigned(const literal*, const literal*) {}
+    bool should_restart() { return false; }
+
+    // For checkpoint.h: the frequencies and phases.
+    void save(checkpoint_writer& out) const {
+        for (unsigned i = frequency.first_index(); i != frequency.end_index(); ++i) {
+            out.put_number(frequency[literal(i)]);
+        }
+        for (int v = phase.first_index(); v != phase.end_index(); ++v) { out.put_signed(phase[v]); }
+    }
+    void load(checkpoint_reader& in) {
+        for (unsigned i = frequency.first_index(); i != frequency.end_index(); ++i) {
+            frequency[literal(i)] = in.get_number();
+        }
+        for (int v = phase.first_index(); v != phase.end_index(); ++v) { phase[v] = in.get_signed(); }
+    }
+
     template<typename C>
     void apply_clause(const C& c) {
         bool should_cut = false;
@@ -5,29 +5,54 @@
 #include "cnf.h"
 #include "debug.h"
 #include "clause_map.h"
+#include "clause_scan.h"
+#include "stamped_set.h"
+#include "profiler.h"
 
 #include <iostream>
+#include <vector>
 
 std::ostream& operator<<(std::ostream& o, const std::pair<literal, cnf::clause_iterator> p) {
     return o << "{" << std::get<0>(p) << "|" << std::get<1>(p) << "}";
 }
 
 class watched_literals {
-    private:
+    public:
     struct watch_struct {
         literal w1, w2;
     };
+    private:
     clause_map<watch_struct> watches_by_clause;
-    literal_map<small_set<cnf::clause_iterator>> watch_lists;
-    small_set<std::pair<literal,cnf::clause_iterator>> units;
+    // A clause is only ever put on the lists of its two watches, so these
+    // needn't check for duplicates.
+    literal_map<std::vector<cnf::clause_iterator>> watch_lists;
+    // The pending units, by literal index, and the clause implying each.
+    sparse_set units;
+    literal_map<cnf::clause_iterator> unit_reasons;
     int clause_count = 0;
 
+    bool is_watched(literal l, cnf::clause_iterator cit) const {
+        const auto& ws = watch_lists[l];
+        return std::find(ws.begin(), ws.end(), cit) != ws.end();
+    }
+    void unwatch(literal l, cnf::clause_iterator cit) {
+        auto& ws = watch_lists[l];
+        auto it = std::find(ws.begin(), ws.end(), cit);
+        ASSERT(it != ws.end());
+        *it = ws.back();
+        ws.pop_back();
+    }
+
 public:
+    // How many watchers ahead apply() prefetches; 0 turns it off. Off by
+    // default: measured fairly (microbench, 200k and 800k variables) it
+    // made no difference we could see.
+    int prefetch_distance = 0;
+
     void print(std::ostream& o) const {
         for (auto i=watch_lists.first_index(); i != watch_lists.end_index(); ++i) {
-            if (i == 0) continue;
-            o << i << " : ";
-            for (auto cit : watch_lists.get_copy(i)) { o << "[" << cit << "]"; }
+            o << literal(i) << " : ";
+            for (auto cit : watch_lists[literal(i)]) { o << "[" << cit << "]"; }
             o << std::endl;
         }
         o << "------------------" << std::endl;
@@ -37,8 +62,8 @@ public:
             o << cit << " : {" << watches_by_clause.get_copy(cit).w1 << ", " << watches_by_clause.get_copy(cit).w2 << "}" << std::endl;
         }
         o << "-------units------" << std::endl;
-        for (auto&& p : units) {
-            o << p.second << " -> " << p.first << std::endl;
+        for (unsigned u : units) {
+            o << unit_reasons[literal(u)] << " -> " << literal(u) << std::endl;
         }
     }
 private:
@@ -53,21 +78,14 @@ private:
         for (auto it = watch_lists.first_index();
                   it != watch_lists.end_index();
                   ++it) {
-            if (it == 0) { continue; };
-            small_set<cnf::clause_iterator> new_watchers;
-            auto old_set = watch_lists[it];
-            for (auto w : old_set) {
-                int index = w - old_base;
-                cnf::clause_iterator new_clause = new_base + index;
-                new_watchers.insert(new_clause);
+            for (auto& w : watch_lists[literal(it)]) {
+                w = new_base + (w - old_base);
             }
-            TRACE("new watch_list for ",  it, ": ", new_watchers, "\n");
-            watch_lists[it] = new_watchers;
         }
 
-        for (auto it = units.begin(); it != units.end(); ++it) {
-            int index = std::get<1>(*it) - old_base;
-            *it = {std::get<0>(*it), new_base + index};
+        for (unsigned u : units) {
+            auto& reason = unit_reasons[literal(u)];
+            reason = new_base + (reason - old_base);
         }
 
         TRACE("Done\n");
@@ -81,18 +99,15 @@ private:
         //print(std::cout);
 
         for (auto i=watch_lists.first_index(); i != watch_lists.end_index(); ++i) {
-            if (i == 0) { continue; }
-            small_set<cnf::clause_iterator> new_watchers;
-            auto old_set = watch_lists[i];
-            for (auto c : old_set) {
+            auto& ws = watch_lists[literal(i)];
+            size_t kept = 0;
+            for (auto c : ws) {
                 int old_index = c - start;
                 ASSERT(old_index >= 0);
                 if (m[old_index] == -1) { continue; } // clause removed
-                auto new_clause = start + m[old_index]; // remap...
-                ASSERT(new_clause - start >= 0);
-                new_watchers.insert(new_clause);
+                ws[kept++] = start + m[old_index]; // remap...
             }
-            watch_lists[i] = new_watchers;
+            ws.resize(kept);
         }
 
         // let's just keep things simple for now..
@@ -111,19 +126,18 @@ private:
                   ++it) {
             //TRACE("WL CHECK: ", it, "\n");
             const auto p = watches_by_clause[it];
-            ASSERT(watch_lists[p.w1].contains(it));
-            if (p.w2) { ASSERT(watch_lists[p.w2].contains(it)); }
+            ASSERT(is_watched(p.w1, it));
+            if (p.w2) { ASSERT(is_watched(p.w2, it)); }
             else { ASSERT(size(it) == 1); }
             ASSERT(p.w1 != p.w2);
         }
         for (auto lit = watch_lists.first_index();
                   lit != watch_lists.end_index();
                   ++lit) {
-            if (lit == 0) { continue; }
             DBGSTMT(
-            for (auto cit : watch_lists[lit]) {
+            for (auto cit : watch_lists[literal(lit)]) {
                 //TRACE("testing: ", cit, " | ", lit, "\n");
-                ASSERT(clause_contains(cit, lit));
+                ASSERT(clause_contains(cit, literal(lit)));
             });
         }
         return true;
@@ -131,12 +145,17 @@ private:
 
     watched_literals(cnf& cnf):
         watches_by_clause(cnf, cnf.clauses_max, cnf.clauses.get()),
-        watch_lists(cnf.max_literal_count)
+        watch_lists(cnf.max_literal_count),
+        units(cnf.max_literal_count + 2),
+        unit_reasons(cnf.max_literal_count)
     {
         for (cnf::clause_iterator it = cnf.clauses.get();
                 it != cnf.clauses.get() + cnf.clauses_count;
                 ++it) {
             add_clause(it);
+            // The input's unit clauses go on the queue, so BCP sets them at
+            // the root before the first decision.
+            if (size(it) == 1) { add_unit(*it->start, it); }
         }
         ASSERT(sanity_check());
 
@@ -149,9 +168,9 @@ private:
     }
 
     std::pair<literal,cnf::clause_iterator> pop_unit() {
-        auto u = *(units.begin());
-        units.erase(u);
-        return u;
+        const literal u(units[0]);
+        units.erase(u.index());
+        return {u, unit_reasons[u]};
     }
 
     void clear_units() {
@@ -160,11 +179,7 @@ private:
     }
 
     void add_unit(literal l, const cnf::clause_iterator c) {
-        if (!units.contains([&](auto set_p) {
-            return std::get<0>(set_p) == l;
-        })) {
-            units.insert({l, c});
-        }
+        if (units.insert(l.index())) { unit_reasons[l] = c; }
     }
 
     void add_clause(cnf::clause_iterator cit, literal l, const assignment& a) {
@@ -172,27 +187,35 @@ private:
         ASSERT(cit->start < cit->finish);
         ASSERT(std::find(begin(cit), end(cit), l) != end(cit));
         literal w1 = l;
-        literal w2 = 0; // case where size is unary.
+        literal w2; // stays empty if the clause is unary.
+        // w2 is the literal that'll be unassigned first: the highest
+        // level, and the latest on the trail within that. (Without
+        // chronological backtracking the latest is always the highest.)
+        int largest_level = -2;
         int largest_index = -2; // must be smaller than any real index.
         for (auto x : cit) {
             if (x == w1) { continue; }
             ASSERT(!a.is_unassigned(x));
             TRACE("About to find decision number: ", -x, "\n");
-            if (a.decision_number(-x) > largest_index) {
+            const int x_level = a.decision_level(-x);
+            if (x_level < largest_level) { continue; }
+            const int x_index = a.decision_number(-x);
+            if (x_level > largest_level || x_index > largest_index) {
                 w2 = x;
-                largest_index = a.decision_number(-x);
+                largest_level = x_level;
+                largest_index = x_index;
             }
         }
 
-        // w2 == 0 if and only if size(cit) == 1
-        ASSERT(size(cit) > 1 || w2 == 0);
-        ASSERT(w2 != 0 || size(cit) == 1);
+        // w2 is empty if and only if size(cit) == 1
+        ASSERT(size(cit) > 1 || !w2);
+        ASSERT(w2 || size(cit) == 1);
 
         ASSERT(w1 != w2);
         TRACE("WL: watched by: ", w1, " ", w2, "\n");
         watches_by_clause[cit] = {w1, w2};
-        watch_lists[w1].insert(cit);
-        if (w2) watch_lists[w2].insert(cit);
+        watch_lists[w1].push_back(cit);
+        if (w2) watch_lists[w2].push_back(cit);
         clause_count++;
 
 
@@ -204,17 +227,14 @@ private:
         ASSERT(cit->start < cit->finish);
         literal w1 = *(cit->start);
         literal w2;
-        if (cit->start+1 == cit->finish) {
-            w2 = 0;
-        }
-        else {
+        if (cit->start+1 != cit->finish) {
             w2 = *(cit->start+1);
         }
         TRACE("WL: watched by: ", w1, " ", w2, "\n");
         ASSERT(w1 != w2);
         watches_by_clause[cit] = {w1, w2};
-        watch_lists[w1].insert(cit);
-        if (w2) watch_lists[w2].insert(cit);
+        watch_lists[w1].push_back(cit);
+        if (w2) watch_lists[w2].push_back(cit);
         clause_count++;
 
 
@@ -223,18 +243,18 @@ private:
 
     template<typename Assignment>
     literal find_new_literal(cnf::clause_iterator cit, const Assignment& a, const watch_struct& p) {
-        if (p.w2 == 0) { return 0; } // if our clause is actually a unit clause, we know we'll fail.
-        literal safe_lit = 0;
-        for (auto x : cit) {
-            if (x == p.w1) { continue; }
-            if (x == p.w2) { continue; }
-            if (a.is_true(x)) { return x; }
-            if (safe_lit == 0 && a.is_unassigned(x)) { safe_lit = x; }
-        }
-        return safe_lit;
+        if (!p.w2) { return literal(); } // if our clause is actually a unit clause, we know we'll fail.
+        PROFILE_SAMPLE(clause_sizes, size(cit));
+        // A true literal if there is one, else an unassigned one.
+        return clause_scan::find_replacement(begin(cit), end(cit), a.values.first_value_iter(),
+                                             p.w1, p.w2);
     }
 
-    bool has_units() const { return units.size() > 0; }
+    bool has_units() const { return !units.empty(); }
+
+    watch_struct watches_of(cnf::clause_iterator cit) const {
+        return watches_by_clause.get_copy(cit);
+    }
 
     template<typename Assignment>
     void reapply(const Assignment& a) {
@@ -245,11 +265,34 @@ private:
 
     template<typename Assignment>
     void apply(const Assignment& a, const literal applied) {
+        PROFILE_SCOPE(phase_watch_apply);
         ASSERT(a.is_true(applied));
 
-        small_set<cnf::clause_iterator> to_visit = watch_lists[-applied];
+        // We go over the list in place, keeping the clauses that stay
+        // watched by -applied at the front: nothing else can be added to
+        // it meanwhile, since the new watches aren't false.
+        auto& to_visit = watch_lists[-applied];
+        PROFILE_SAMPLE(watch_list_lengths, to_visit.size());
         TRACE("WL: from applied ", applied, " considering clauses:\n");
-        for (cnf::clause_iterator cit : to_visit) {
+        const int visit_count = to_visit.size();
+        const int k = prefetch_distance;
+        int kept = 0;
+        for (int i = 0; i < visit_count; ++i) {
+            // Each watcher costs up to three dependent misses: its watches,
+            // the clause header, and the literals the header points to. So
+            // we ask for the first two k watchers ahead, and the literals
+            // k/2 ahead, by which time that header should have arrived.
+            if (k) {
+                if (i + k < visit_count) {
+                    cnf::clause_iterator ahead = to_visit[i + k];
+                    __builtin_prefetch(&watches_by_clause[ahead]);
+                    __builtin_prefetch(ahead);
+                }
+                if (i + k / 2 < visit_count) {
+                    __builtin_prefetch(to_visit[i + k / 2]->start);
+                }
+            }
+            cnf::clause_iterator cit = to_visit[i];
             watch_struct& p = watches_by_clause[cit];
             TRACE("WL: clause ", cit, " watched by ", p.w1, " ", p.w2, "\n");
 
@@ -257,36 +300,40 @@ private:
             ASSERT(p.w1 == -applied);
 
             // This is a unit clause.
-            if (p.w2 == 0) {
+            if (!p.w2) {
                 TRACE("WL: found failed clause ", cit, "\n");
                 // this must have been implied, but also contradicted.
                 add_unit(-applied, cit);
+                to_visit[kept++] = cit;
                 continue;
             }
 
-            ASSERT(p.w2 != 0);
+            ASSERT(p.w2);
 
             if (a.is_false(p.w2)) {
                 literal wn = find_new_literal(cit, a, p);
                 if (wn) {
-                    watch_lists[p.w2].erase(cit);
-                    watch_lists[wn].insert(cit);
+                    unwatch(p.w2, cit);
+                    watch_lists[wn].push_back(cit);
                     p.w2 = wn;
                 }
                 else {
                     TRACE("WL: found failed clause ", cit, "\n");
                     // this must have been implied, but also contradicted.
                     add_unit(-applied, cit);
+                    to_visit[kept++] = cit;
                     continue;
                 }
             }
 
-            if (a.is_true(p.w2)) { continue; }
+            if (a.is_true(p.w2)) {
+                to_visit[kept++] = cit;
+                continue;
+            }
 
             literal wn = find_new_literal(cit, a, p);
             if (wn) {
-                watch_lists[p.w1].erase(cit);
-                watch_lists[wn].insert(cit);
+                watch_lists[wn].push_back(cit);
                 p.w1 = wn;
                 ASSERT(!a.is_false(p.w1) && !a.is_false(p.w2));
             }
@@ -294,9 +341,11 @@ private:
                 TRACE("WL: found new unit: ", cit, " by ", p.w2, "\n");
                 ASSERT(p.w2 == clause_implies(cit, a));
                 add_unit(p.w2, cit);
+                to_visit[kept++] = cit;
             }
         }
-        TRACE("WL: done applying ", applied, " unit set: ", units, "\n");
+        to_visit.resize(kept);
+        TRACE("WL: done applying ", applied, ", ", units.size(), " units\n");
         ASSERT(sanity_check());
     }
 };
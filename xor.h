@@ -0,0 +1,305 @@
+#ifndef XOR_H
+#define XOR_H
+
+#include "cnf.h"
+#include "assignment.h"
+#include "watched_literals.h"
+#include "clause_scan.h"
+#include "stats.h"
+#include "profiler.h"
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+// Parity reasoning. An xor over k variables is written in CNF as 2^(k-1)
+// clauses, which BCP can only use one at a time; here we find those xors
+// and do Gauss-Jordan elimination over them instead.
+
+struct xor_constraint {
+    std::vector<int> vars; // sorted
+    bool rhs;              // the xor of the vars is rhs
+};
+
+// Clause (l1 ... lk) rules out exactly one assignment to its variables,
+// the one making every li false; x1 ^ ... ^ xk = rhs rules out the half
+// with the wrong parity. So we bucket the clauses by their set of
+// variables (by a hash signature, then confirming), and within a bucket,
+// by the parity of their negations: a full house of 2^(k-1) distinct sign
+// patterns of one parity is an xor.
+std::vector<xor_constraint> find_xors(const cnf& c, int max_size = 5) {
+    PROFILE_SCOPE(phase_xor);
+    struct candidate {
+        uint64_t signature;
+        int clause;
+    };
+    std::vector<candidate> candidates;
+    std::vector<int> vars;
+    auto sorted_vars = [&](cnf::clause_iterator cit) {
+        vars.clear();
+        for (literal l : cit) { vars.push_back(l.var()); }
+        std::sort(vars.begin(), vars.end());
+    };
+    for (auto cit = c.clause_begin(); cit != c.clause_end(); ++cit) {
+        const int k = size(cit);
+        if (k < 2 || k > max_size) { continue; }
+        sorted_vars(cit);
+        // x and -x together: a tautology, nothing to do with any xor.
+        if (std::adjacent_find(vars.begin(), vars.end()) != vars.end()) { continue; }
+        uint64_t h = k;
+        for (int v : vars) { h = (h ^ v) * 0x100000001b3ull; }
+        candidates.push_back({h, int(cit - c.clause_begin())});
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const candidate& x, const candidate& y) {
+        return x.signature < y.signature || (x.signature == y.signature && x.clause < y.clause);
+    });
+
+    std::vector<xor_constraint> result;
+    std::vector<int> group_vars;
+    for (size_t i = 0; i < candidates.size(); ) {
+        size_t j = i;
+        while (j < candidates.size() && candidates[j].signature == candidates[i].signature) { ++j; }
+        // Within a signature, clauses over the same variables (hashes can
+        // collide, so we check) -- the sign patterns seen, per parity.
+        std::vector<bool> used(j - i, false);
+        for (size_t a = i; a < j; ++a) {
+            if (used[a - i]) { continue; }
+            sorted_vars(c.clause_begin() + candidates[a].clause);
+            group_vars = vars;
+            const int k = group_vars.size();
+            uint32_t seen[2] = {0, 0};
+            for (size_t b = a; b < j; ++b) {
+                if (used[b - i]) { continue; }
+                auto cit = c.clause_begin() + candidates[b].clause;
+                sorted_vars(cit);
+                if (vars != group_vars) { continue; }
+                used[b - i] = true;
+                unsigned pattern = 0;
+                for (literal l : cit) {
+                    if (!l.is_negative()) { continue; }
+                    int pos = std::lower_bound(group_vars.begin(), group_vars.end(), l.var()) - group_vars.begin();
+                    pattern |= 1u << pos;
+                }
+                seen[__builtin_popcount(pattern) & 1] |= 1u << pattern;
+            }
+            const int full = 1 << (k - 1);
+            for (int parity = 0; parity < 2; ++parity) {
+                if (__builtin_popcount(seen[parity]) == full) {
+                    result.push_back({group_vars, parity == 0});
+                }
+            }
+        }
+        i = j;
+    }
+    return result;
+}
+
+// Xor rows as bit vectors, 64 columns to a word; with AVX2, four words at
+// a time.
+#ifdef CLAUSE_SCAN_AVX2
+__attribute__((target("avx2")))
+void xor_row_avx2(uint64_t* dst, const uint64_t* src, int words) {
+    int i = 0;
+    for (; i + 4 <= words; i += 4) {
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_xor_si256(d, s));
+    }
+    for (; i < words; ++i) { dst[i] ^= src[i]; }
+}
+#endif
+void xor_row(uint64_t* dst, const uint64_t* src, int words) {
+#ifdef CLAUSE_SCAN_AVX2
+    if (clause_scan::use_avx2 && words >= 4) {
+        xor_row_avx2(dst, src, words);
+        return;
+    }
+#endif
+    for (int i = 0; i < words; ++i) { dst[i] ^= src[i]; }
+}
+
+// The engine. At each BCP fixpoint we take the xor rows, fold in the
+// current assignment, and run Gauss-Jordan over the unassigned columns.
+// A row with no unassigned columns left and odd parity is a conflict; one
+// with a single unassigned column implies it. The reason in either case
+// is the row itself as a clause: the implied literal (if any), and each
+// assigned variable of the row in its currently-false polarity. We learn
+// that clause (it follows from the xors, so from the input), so BCP and
+// conflict analysis see xor reasoning as ordinary clauses.
+//
+// These lemmas aren't RUP in general, so this can't be used with proofs.
+class gauss_elimination {
+    std::vector<int> col_var;
+    std::vector<int> var_col; // -1 if not in any xor
+    int words = 0;
+    std::vector<uint64_t> rows;
+    std::vector<unsigned char> rhs;
+
+    // Scratch, and the assignment we last looked at (if nothing's changed
+    // there's nothing new to find).
+    std::vector<uint64_t> m;
+    std::vector<unsigned char> m_rhs;
+    std::vector<uint64_t> assigned, value, last_assigned, last_value;
+    std::vector<literal> lemma;
+
+    int row_count() const { return rhs.size(); }
+    uint64_t* row(std::vector<uint64_t>& v, int r) { return v.data() + size_t(r) * words; }
+
+    static bool test(const uint64_t* bits, int col) { return (bits[col >> 6] >> (col & 63)) & 1; }
+
+    // The clause for row r of m, and its place in the cnf.
+    template<typename ReductionPolicy>
+    cnf::clause_iterator learn(cnf& c, const assignment& a, watched_literals& w, ReductionPolicy& d,
+                               int r, literal implied) {
+        lemma.clear();
+        if (implied) { lemma.push_back(implied); }
+        const uint64_t* bits = row(m, r);
+        for (int i = 0; i < words; ++i) {
+            uint64_t x = bits[i] & assigned[i];
+            while (x) {
+                const int col = i * 64 + __builtin_ctzll(x);
+                x &= x - 1;
+                const literal l = literal::positive(col_var[col]);
+                lemma.push_back(a.is_true(l) ? -l : l);
+            }
+        }
+        c.consider_resizing();
+        auto cit = c.insert_clause(lemma);
+        d.learned(cit, size(cit));
+        if (implied) {
+            w.add_clause(cit, implied, a);
+        }
+        else {
+            // A conflict: watch the two literals assigned last, so the
+            // watches are right once we backjump.
+            std::sort(cit->start, cit->finish, [&](literal x, literal y) {
+                return a.decision_number(-x) > a.decision_number(-y);
+            });
+            w.add_clause(cit);
+        }
+        return cit;
+    }
+
+public:
+    // Lemmas from parity reasoning aren't RUP, so no proofs.
+    static const bool proof_compatible = false;
+    // Set when the xors contradict each other by themselves.
+    bool unsat = false;
+
+    gauss_elimination(cnf& c, statistics& stats) {
+        auto xors = find_xors(c);
+        STAT(stats.xors = xors.size());
+        (void)stats;
+        const int n = c.max_literal_count / 2;
+        var_col.assign(n + 1, -1);
+        for (const auto& x : xors) {
+            for (int v : x.vars) {
+                if (var_col[v] >= 0) { continue; }
+                var_col[v] = col_var.size();
+                col_var.push_back(v);
+            }
+        }
+        words = (col_var.size() + 63) / 64;
+        rows.assign(xors.size() * words, 0);
+        for (size_t r = 0; r < xors.size(); ++r) {
+            for (int v : xors[r].vars) {
+                const int col = var_col[v];
+                row(rows, r)[col >> 6] |= 1ull << (col & 63);
+            }
+            rhs.push_back(xors[r].rhs);
+        }
+        m.resize(rows.size());
+        assigned.assign(words, 0);
+        value.assign(words, 0);
+    }
+
+    // Run at a BCP fixpoint. Either returns a (learned, false) conflict
+    // clause, or queues any implied literals as units with their learned
+    // reasons and returns nullptr, or sets unsat.
+    template<typename ReductionPolicy>
+    cnf::clause_iterator propagate(cnf& c, const assignment& a, watched_literals& w,
+                                   ReductionPolicy& d, statistics& stats) {
+        if (rhs.empty()) { return nullptr; }
+        std::fill(assigned.begin(), assigned.end(), 0);
+        std::fill(value.begin(), value.end(), 0);
+        for (size_t col = 0; col < col_var.size(); ++col) {
+            const literal l = literal::positive(col_var[col]);
+            if (a.is_unassigned(l)) { continue; }
+            assigned[col >> 6] |= 1ull << (col & 63);
+            if (a.is_true(l)) { value[col >> 6] |= 1ull << (col & 63); }
+        }
+        if (assigned == last_assigned && value == last_value) { return nullptr; }
+        PROFILE_SCOPE(phase_xor);
+
+        m = rows;
+        m_rhs = rhs;
+        const int R = row_count();
+        for (int r = 0; r < R; ++r) {
+            uint64_t* pr = row(m, r);
+            int pivot = -1;
+            for (int i = 0; i < words && pivot < 0; ++i) {
+                const uint64_t free = pr[i] & ~assigned[i];
+                if (free) { pivot = i * 64 + __builtin_ctzll(free); }
+            }
+            if (pivot < 0) { continue; }
+            for (int s = 0; s < R; ++s) {
+                if (s == r || !test(row(m, s), pivot)) { continue; }
+                xor_row(row(m, s), pr, words);
+                m_rhs[s] ^= m_rhs[r];
+            }
+        }
+
+        bool found = false;
+        for (int r = 0; r < R; ++r) {
+            const uint64_t* pr = row(m, r);
+            int free_count = 0, free_col = -1;
+            unsigned parity = m_rhs[r];
+            for (int i = 0; i < words; ++i) {
+                const uint64_t free = pr[i] & ~assigned[i];
+                if (free) {
+                    free_count += __builtin_popcountll(free);
+                    free_col = i * 64 + __builtin_ctzll(free);
+                }
+                parity ^= __builtin_popcountll(pr[i] & value[i]) & 1;
+            }
+            if (free_count == 0 && parity) {
+                STAT(stats.xor_conflicts++);
+                if (std::none_of(pr, pr + words, [](uint64_t x) { return x != 0; })) {
+                    // 0 = 1 from the xors alone: there's no clause to
+                    // blame, the formula's just unsat.
+                    unsat = true;
+                    return nullptr;
+                }
+                return learn(c, a, w, d, r, literal());
+            }
+            if (free_count == 1) {
+                literal l = literal::positive(col_var[free_col]);
+                if (!parity) { l = -l; }
+                auto cit = learn(c, a, w, d, r, l);
+                w.add_unit(l, cit);
+                STAT(stats.xor_propagations++);
+                found = true;
+            }
+        }
+        // With new units on the way the assignment will change; otherwise
+        // we've said all we can about this one.
+        if (!found) {
+            last_assigned = assigned;
+            last_value = value;
+        }
+        return nullptr;
+    }
+};
+
+// No xor reasoning: what we've always done.
+struct no_xors {
+    static const bool proof_compatible = true;
+    static const bool unsat = false;
+    no_xors(cnf&, statistics&) {}
+    template<typename ReductionPolicy>
+    cnf::clause_iterator propagate(cnf&, const assignment&, watched_literals&, ReductionPolicy&, statistics&) {
+        return nullptr;
+    }
+};
+
+#endif